@@ -0,0 +1,62 @@
+#pragma once
+#include "ga/math.h"
+#include <iostream>
+
+namespace ga {
+
+// max absolute error of the two cubic bezier paths, against a double precision reference, over the same samples
+struct BezierAccuracy
+{
+	size_t samples     = 0;
+	double easeError   = 0.;  // CubicBezierEase - the table + Newton path the material eases use
+	float easeErrorX   = 0.f;  // where it's worst
+	double solverError = 0.;  // cubicBezier() - fixed Newton iterations
+	float solverErrorX = 0.f;
+};
+
+inline std::ostream& operator<<( std::ostream& os, const BezierAccuracy& a )
+{
+	return os << a.samples << " samples - CubicBezierEase: " << a.easeError << " (at x " << a.easeErrorX << "), cubicBezier(): " << a.solverError
+	          << " (at x " << a.solverErrorX << ")";
+}
+
+// y for x on the curve through (0,0), (x1,y1), (x2,y2), (1,1) - bisection in double precision
+inline double cubicBezierReference( double x, double x1, double y1, double x2, double y2 )
+{
+	auto sample = []( double t, double p1, double p2 ) { return 3. * ( 1. - t ) * ( 1. - t ) * t * p1 + 3. * ( 1. - t ) * t * t * p2 + t * t * t; };
+	double lo = 0., hi = 1.;
+	for ( int i = 0; i < 64; ++i ) {
+		double t = ( lo + hi ) * .5;
+		if ( sample( t, x1, x2 ) < x )
+			lo = t;
+		else
+			hi = t;
+	}
+	return sample( ( lo + hi ) * .5, y1, y2 );
+}
+
+// i.e. std::cout << ga::checkBezierAccuracy( 0.4f, 0.0f, 0.2f, 1.0f ) << std::endl;  // material
+inline BezierAccuracy checkBezierAccuracy( float x1, float y1, float x2, float y2, size_t samples = 100001 )
+{
+	BezierAccuracy a;
+	a.samples = samples;
+	CubicBezierEase ease( x1, y1, x2, y2 );
+	double step = samples > 1 ? 1. / ( samples - 1 ) : 0.;
+	for ( size_t i = 0; i < samples; ++i ) {
+		float x          = float( i * step );
+		double reference = cubicBezierReference( x, x1, y1, x2, y2 );
+		double error     = std::abs( ease( x ) - reference );
+		if ( error > a.easeError ) {
+			a.easeError  = error;
+			a.easeErrorX = x;
+		}
+		error = std::abs( cubicBezier( x, x1, y1, x2, y2 ) - reference );
+		if ( error > a.solverError ) {
+			a.solverError  = error;
+			a.solverErrorX = x;
+		}
+	}
+	return a;
+}
+
+}  // namespace ga
@@ -0,0 +1,134 @@
+#pragma once
+#include "ga/math.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace ga {
+
+/**
+ * @brief Bvh is a bounding volume hierarchy of boxes, with one leaf per item.
+ *
+ * Items are identified by their index in the vector passed to build().
+ * Moving items are handled with update(), which refits only the leaf's ancestors,
+ * so the tree only needs a full rebuild when items are added or removed.
+ */
+class Bvh
+{
+public:
+	void build( const std::vector<Bounds3D>& boxes )
+	{
+		m_nodes.clear();
+		m_leaves.assign( boxes.size(), -1 );
+		if ( boxes.empty() )
+			return;
+
+		m_nodes.reserve( boxes.size() * 2 - 1 );
+		m_buildItems.resize( boxes.size() );
+		for ( uint32_t i = 0; i < boxes.size(); ++i ) {
+			m_buildItems[i] = i;
+		}
+		buildRange( boxes, 0, boxes.size(), -1 );
+	}
+
+	// move an item's box, refitting its ancestors
+	void update( uint32_t item, const Bounds3D& box )
+	{
+		if ( item >= m_leaves.size() )
+			return;
+		int32_t index      = m_leaves[item];
+		m_nodes[index].box = box;
+		// walk up, stopping once an ancestor's box doesn't change
+		for ( int32_t parent = m_nodes[index].parent; parent >= 0; parent = m_nodes[parent].parent ) {
+			auto& node = m_nodes[parent];
+			auto fit   = m_nodes[node.left].box;
+			fit.include( m_nodes[node.right].box );
+			if ( fit.min == node.box.min && fit.max == node.box.max )
+				break;
+			node.box = fit;
+		}
+	}
+
+	// calls fn( item, t ) for every item whose box is hit by the ray, in no particular order
+	template <typename Fn>
+	void raycast( const Ray& ray, Fn fn ) const
+	{
+		if ( m_nodes.empty() )
+			return;
+		m_stack.clear();
+		m_stack.push_back( 0 );
+		while ( !m_stack.empty() ) {
+			auto& node = m_nodes[m_stack.back()];
+			m_stack.pop_back();
+			float t;
+			if ( !ray.intersects( node.box, t ) )
+				continue;
+			if ( node.left < 0 ) {
+				fn( node.item, t );
+			} else {
+				m_stack.push_back( node.left );
+				m_stack.push_back( node.right );
+			}
+		}
+	}
+
+	size_t size() const { return m_leaves.size(); }
+
+	void clear()
+	{
+		m_nodes.clear();
+		m_leaves.clear();
+	}
+
+protected:
+	struct Node
+	{
+		Bounds3D box;
+		int32_t parent = -1;
+		int32_t left   = -1;  // -1 for leaves
+		int32_t right  = -1;
+		uint32_t item  = 0;  // leaves only
+	};
+
+	// top down build, splitting at the median centroid along the longest axis
+	int32_t buildRange( const std::vector<Bounds3D>& boxes, size_t begin, size_t end, int32_t parent )
+	{
+		int32_t index = ( int32_t )m_nodes.size();
+		m_nodes.push_back( Node() );
+		m_nodes[index].parent = parent;
+
+		if ( end - begin == 1 ) {
+			auto item           = m_buildItems[begin];
+			m_nodes[index].item = item;
+			m_nodes[index].box  = boxes[item];
+			m_leaves[item]      = index;
+			return index;
+		}
+
+		Bounds3D centroids = Bounds3D::empty();
+		for ( size_t i = begin; i < end; ++i ) {
+			centroids.include( boxes[m_buildItems[i]].center() );
+		}
+		vec3 size  = centroids.size();
+		int axis   = size.x > size.y ? ( size.x > size.z ? 0 : 2 ) : ( size.y > size.z ? 1 : 2 );
+		size_t mid = begin + ( end - begin ) / 2;
+		std::nth_element( m_buildItems.begin() + begin, m_buildItems.begin() + mid, m_buildItems.begin() + end,
+		                  [&]( uint32_t a, uint32_t b ) { return boxes[a].center()[axis] < boxes[b].center()[axis]; } );
+
+		int32_t left  = buildRange( boxes, begin, mid, index );
+		int32_t right = buildRange( boxes, mid, end, index );
+		auto& node    = m_nodes[index];
+		node.left     = left;
+		node.right    = right;
+		node.box      = m_nodes[left].box;
+		node.box.include( m_nodes[right].box );
+		return index;
+	}
+
+	std::vector<Node> m_nodes;             // m_nodes[0] is the root
+	std::vector<int32_t> m_leaves;         // item -> leaf node index
+	std::vector<uint32_t> m_buildItems;    // build scratch
+	mutable std::vector<int32_t> m_stack;  // traversal scratch
+};
+
+}  // namespace ga
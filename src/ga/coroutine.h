@@ -0,0 +1,444 @@
+#pragma once
+
+// C++20 coroutines - the rest of ga builds as C++14, so this is only available
+// when built as C++20 or later (GA_HAS_COROUTINES is then defined)
+#if defined( __cpp_impl_coroutine ) && __has_include( <coroutine> )
+#define GA_HAS_COROUTINES 1
+
+#include "ga/graph/components/timeline_component.h"
+#include "ga/graph/components/touchzone_component.h"
+#include "ga/pool.h"
+#include "ga/signal.h"
+#include "ga/small_function.h"
+#include "ga/timeout.h"
+#include "ga/timer.h"
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <vector>
+
+namespace ga {
+
+/**
+ * @brief CoroutineScheduler resumes suspended Sequences, once per Scene::update() (after the nodes update) -
+ * when their delay is up, their condition is met, or an event they wait for has fired.
+ *
+ * A coroutine is only ever resumed from update(), never from inside a timeout, tween or signal callback.
+ * Coroutine frames are allocated from pools, and the stats and resume hook are there for profiling.
+ */
+class CoroutineScheduler
+{
+public:
+	using Handle = std::coroutine_handle<>;
+
+	struct Stats
+	{
+		size_t numFrames     = 0;  // live coroutine frames
+		size_t numWaiting    = 0;  // waiting on a condition (polled every update)
+		size_t numResumed    = 0;  // in the last update
+		size_t totalResumed  = 0;
+		double updateSeconds = 0.;  // duration of the last update, including the coroutines it resumed
+	};
+
+	// resume every coroutine that's ready - called by Scene::update(), only once per clock frame
+	// (not per clock time, which stands still while paused and differs for each fixed update step)
+	void update()
+	{
+		if ( auto clock = m_timeouts.getClock() ) {
+			auto frame = clock->getFrameCount();
+			if ( m_hasUpdated && frame == m_lastFrame )
+				return;  // i.e. several scenes, or fixed update steps, in one frame
+			m_lastFrame  = frame;
+			m_hasUpdated = true;
+		}
+
+		auto start = Clock::now();
+
+		// due delays go to the ready queue
+		m_timeouts.updateTimeouts();
+
+		// polled conditions
+		for ( size_t i = 0; i < m_waits.size(); ) {
+			if ( m_waits[i].isReady() ) {
+				m_ready.push_back( m_waits[i].handle );
+				m_waits[i] = std::move( m_waits.back() );
+				m_waits.pop_back();
+			} else {
+				++i;
+			}
+		}
+
+		// coroutines scheduled while resuming wait for the next update
+		m_resuming.swap( m_ready );
+		m_stats.numResumed = 0;
+		for ( size_t i = 0; i < m_resuming.size(); ++i ) {
+			auto handle = m_resuming[i];
+			if ( !handle )
+				continue;  // cancelled
+			m_resuming[i] = nullptr;
+			if ( m_onResume )
+				m_onResume( handle );
+			++m_stats.numResumed;
+			handle.resume();
+		}
+		m_resuming.clear();
+
+		m_stats.totalResumed += m_stats.numResumed;
+		m_stats.numWaiting    = m_waits.size();
+		m_stats.updateSeconds = std::chrono::duration<double>( Clock::now() - start ).count();
+	}
+
+	// resume 'handle' on the next update
+	void schedule( Handle handle ) { m_ready.push_back( handle ); }
+
+	// resume 'handle' on the first update that 'isReady' returns true
+	void waitUntil( Handle handle, SmallFunction<bool()> isReady ) { m_waits.push_back( { handle, std::move( isReady ) } ); }
+
+	// resume 'handle' after 'delayMs', on the scheduler's clock - returns the timeout, for cancelTimeout()
+	TimeoutHandle waitFor( Handle handle, long long delayMs )
+	{
+		return m_timeouts.addTimeout( delayMs, [this, handle]() { m_ready.push_back( handle ); } );
+	}
+	void cancelTimeout( TimeoutHandle timeout ) { m_timeouts.cancelTimeout( timeout ); }
+
+	// drop 'handle' from the waits and the ready queue (i.e. its coroutine is being destroyed)
+	void cancel( Handle handle )
+	{
+		m_waits.erase( std::remove_if( m_waits.begin(), m_waits.end(), [handle]( const Wait& wait ) { return wait.handle == handle; } ), m_waits.end() );
+		m_ready.erase( std::remove( m_ready.begin(), m_ready.end(), handle ), m_ready.end() );
+		std::replace( m_resuming.begin(), m_resuming.end(), handle, Handle() );
+	}
+
+	// called before every resume
+	void setOnResume( SmallFunction<void( Handle )> onResume ) { m_onResume = std::move( onResume ); }
+
+	const Stats& getStats() const { return m_stats; }
+
+	// the clock delays are timed with - getFrameClock() by default
+	void setClock( FrameClock* clock ) { m_timeouts.setClock( clock ); }
+
+	// coroutine frames come from size class pools (larger ones from the heap)
+	void* allocateFrame( size_t size )
+	{
+		++m_stats.numFrames;
+		if ( size <= 256 )
+			return getBlockPool<256, alignof( std::max_align_t )>().allocate();
+		if ( size <= 512 )
+			return getBlockPool<512, alignof( std::max_align_t )>().allocate();
+		if ( size <= 1024 )
+			return getBlockPool<1024, alignof( std::max_align_t )>().allocate();
+		return ::operator new( size );
+	}
+	void freeFrame( void* frame, size_t size )
+	{
+		--m_stats.numFrames;
+		if ( size <= 256 )
+			getBlockPool<256, alignof( std::max_align_t )>().deallocate( frame );
+		else if ( size <= 512 )
+			getBlockPool<512, alignof( std::max_align_t )>().deallocate( frame );
+		else if ( size <= 1024 )
+			getBlockPool<1024, alignof( std::max_align_t )>().deallocate( frame );
+		else
+			::operator delete( frame );
+	}
+
+protected:
+	struct Wait
+	{
+		Handle handle;
+		SmallFunction<bool()> isReady;
+	};
+
+	TimeoutManager m_timeouts;
+	std::vector<Wait> m_waits;
+	std::vector<Handle> m_ready;
+	std::vector<Handle> m_resuming;  // (scratch)
+	SmallFunction<void( Handle )> m_onResume;
+	Stats m_stats;
+	uint64_t m_lastFrame = 0;
+	bool m_hasUpdated    = false;
+};
+
+// singleton, updated by Scene::update()
+inline CoroutineScheduler& getCoroutineScheduler()
+{
+	static CoroutineScheduler s;
+	return s;
+}
+
+/**
+ * @brief Sequence is a coroutine for animation sequencing - it runs until its first co_await right away,
+ * then is resumed by the CoroutineScheduler. Destroying the Sequence stops it, wherever it's waiting.
+ *
+ *		Sequence intro( std::shared_ptr<Timeline> timeline, std::shared_ptr<TouchZone> zone )
+ *		{
+ *			auto fade = timeline->add( 0.f, 1.f, easeFn( EaseType::LINEAR ), setAlpha );
+ *			fade->startNow( 300 );
+ *			co_await co::done( fade );
+ *			co_await co::delay( 2000 );
+ *			auto event = co_await co::touch( zone, TouchZone::Event::Type::PRESS );
+ *			...
+ *		}
+ *		m_intro = intro( timeline, zone );  // or intro( timeline, zone ).detach();
+ *
+ * A Sequence can co_await another, resuming when it's done (and rethrowing its exception, if any).
+ */
+class Sequence
+{
+public:
+	struct promise_type;
+	using Handle = std::coroutine_handle<promise_type>;
+
+	struct FinalAwaiter
+	{
+		bool await_ready() noexcept { return false; }
+		std::coroutine_handle<> await_suspend( Handle handle ) noexcept
+		{
+			auto& promise = handle.promise();
+			if ( promise.continuation )
+				return promise.continuation;
+			if ( promise.isDetached )
+				handle.destroy();
+			return std::noop_coroutine();
+		}
+		void await_resume() noexcept {}
+	};
+
+	struct promise_type
+	{
+		Sequence get_return_object() { return Sequence( Handle::from_promise( *this ) ); }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		FinalAwaiter final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception()
+		{
+			// todo: log exception (a detached sequence has nobody to rethrow it to)
+			exception = std::current_exception();
+		}
+
+		static void* operator new( size_t size ) { return getCoroutineScheduler().allocateFrame( size ); }
+		static void operator delete( void* frame, size_t size ) { getCoroutineScheduler().freeFrame( frame, size ); }
+
+		std::coroutine_handle<> continuation;  // a sequence awaiting this one
+		std::exception_ptr exception;
+		bool isDetached = false;
+	};
+
+	Sequence() = default;
+	~Sequence() { reset(); }
+
+	Sequence( const Sequence& ) = delete;
+	Sequence& operator=( const Sequence& ) = delete;
+	Sequence( Sequence&& other ) noexcept
+	    : m_handle( other.m_handle )
+	{
+		other.m_handle = nullptr;
+	}
+	Sequence& operator=( Sequence&& other ) noexcept
+	{
+		if ( this != &other ) {
+			reset();
+			m_handle       = other.m_handle;
+			other.m_handle = nullptr;
+		}
+		return *this;
+	}
+
+	// true once the coroutine has returned (or if there is none)
+	bool isDone() const { return !m_handle || m_handle.done(); }
+
+	// stop the coroutine, wherever it's waiting
+	void reset()
+	{
+		if ( m_handle ) {
+			m_handle.destroy();
+			m_handle = nullptr;
+		}
+	}
+
+	// let the coroutine run to the end on its own - it's destroyed when it returns
+	void detach()
+	{
+		if ( !m_handle )
+			return;
+		if ( m_handle.done() )
+			m_handle.destroy();
+		else
+			m_handle.promise().isDetached = true;
+		m_handle = nullptr;
+	}
+
+	// co_await a sequence, to resume when it's done
+	auto operator co_await() && noexcept
+	{
+		struct Awaiter
+		{
+			Handle handle;
+			bool await_ready() noexcept { return !handle || handle.done(); }
+			void await_suspend( std::coroutine_handle<> continuation ) noexcept { handle.promise().continuation = continuation; }
+			void await_resume()
+			{
+				if ( handle && handle.promise().exception )
+					std::rethrow_exception( handle.promise().exception );
+			}
+		};
+		return Awaiter{ m_handle };
+	}
+
+protected:
+	explicit Sequence( Handle handle )
+	    : m_handle( handle )
+	{
+	}
+
+	Handle m_handle;
+};
+
+// awaitables for Sequences
+namespace co {
+
+// base for awaiters resumed by the scheduler - if its coroutine is destroyed while waiting, it's dropped from the scheduler
+struct ScheduledAwaiter
+{
+	ScheduledAwaiter() = default;
+	ScheduledAwaiter( const ScheduledAwaiter& ) = delete;
+	~ScheduledAwaiter()
+	{
+		if ( waiting )
+			getCoroutineScheduler().cancel( waiting );
+	}
+
+	std::coroutine_handle<> waiting;  // while suspended
+};
+
+// resume on the next update
+struct NextUpdate : ScheduledAwaiter
+{
+	bool await_ready() { return false; }
+	void await_suspend( std::coroutine_handle<> handle )
+	{
+		waiting = handle;
+		getCoroutineScheduler().schedule( handle );
+	}
+	void await_resume() { waiting = nullptr; }
+};
+inline NextUpdate nextUpdate() { return {}; }
+
+// resume once 'isReady' returns true, checked every update - without suspending if it already is
+struct Until : ScheduledAwaiter
+{
+	Until( SmallFunction<bool()> fn )
+	    : isReady( std::move( fn ) )
+	{
+	}
+
+	bool await_ready() { return !isReady || isReady(); }
+	void await_suspend( std::coroutine_handle<> handle )
+	{
+		waiting = handle;
+		getCoroutineScheduler().waitUntil( handle, std::move( isReady ) );
+	}
+	void await_resume() { waiting = nullptr; }
+
+	SmallFunction<bool()> isReady;
+};
+inline Until until( SmallFunction<bool()> isReady ) { return Until( std::move( isReady ) ); }
+
+// resume after 'delayMs' (a timeout on the scheduler's TimeoutManager)
+struct Delay : ScheduledAwaiter
+{
+	Delay( long long ms )
+	    : delayMs( ms )
+	{
+	}
+	~Delay()
+	{
+		if ( timeout )
+			getCoroutineScheduler().cancelTimeout( timeout );
+	}
+
+	bool await_ready() { return delayMs <= 0; }
+	void await_suspend( std::coroutine_handle<> handle )
+	{
+		waiting = handle;
+		timeout = getCoroutineScheduler().waitFor( handle, delayMs );
+	}
+	void await_resume()
+	{
+		waiting = nullptr;
+		timeout = 0;
+	}
+
+	long long delayMs;
+	TimeoutHandle timeout = 0;
+};
+inline Delay delay( long long delayMs ) { return Delay( delayMs ); }
+
+// resume when a tween (Tween, KeyframeTween, PathTween, TweenGroup...) has finished, or is destroyed -
+// a tween that isn't running (i.e. not started yet) counts as finished
+template <typename TweenT>
+inline Until done( const std::shared_ptr<TweenT>& tween )
+{
+	std::weak_ptr<TweenT> weak = tween;
+	return Until( [weak]() {
+		auto tween = weak.lock();
+		return !tween || !tween->isSet() || tween->isDone();
+	} );
+}
+
+// resume when a timeline has no tweens left running (when onTimelineDone fires), or is destroyed
+inline Until done( const std::shared_ptr<Timeline>& timeline )
+{
+	std::weak_ptr<Timeline> weak = timeline;
+	return Until( [weak]() {
+		auto timeline = weak.lock();
+		return !timeline || !timeline->isActive();
+	} );
+}
+
+// resume on the next touch event of a zone (of any type, or just 'type') - co_await returns the event
+struct Touch : ScheduledAwaiter
+{
+	Touch( const std::shared_ptr<TouchZone>& touchZone, bool filter, TouchZone::Event::Type eventType )
+	    : zone( touchZone )
+	    , isFiltered( filter )
+	    , type( eventType )
+	{
+	}
+
+	bool await_ready() { return !zone; }
+	void await_suspend( std::coroutine_handle<> handle )
+	{
+		waiting    = handle;
+		connection = zone->onTouchEvent.connect( [this]( TouchZone::Event& e ) {
+			if ( hasEvent || ( isFiltered && e.type != type ) )
+				return;
+			event    = e;
+			hasEvent = true;
+			getCoroutineScheduler().schedule( waiting );
+		} );
+	}
+	TouchZone::Event await_resume()
+	{
+		waiting = nullptr;
+		connection.disconnect();
+		return event;
+	}
+
+	std::shared_ptr<TouchZone> zone;
+	bool isFiltered;
+	TouchZone::Event::Type type;
+	TouchZone::Event event = {};
+	bool hasEvent          = false;
+	ScopedConnection connection;
+};
+inline Touch touch( const std::shared_ptr<TouchZone>& zone ) { return Touch( zone, false, TouchZone::Event::Type::PRESS ); }
+inline Touch touch( const std::shared_ptr<TouchZone>& zone, TouchZone::Event::Type type ) { return Touch( zone, true, type ); }
+
+}  // namespace co
+
+}  // namespace ga
+
+#endif
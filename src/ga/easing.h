@@ -1,5 +1,6 @@
 #pragma once
 #include "ga/math.h"
+#include <cmath>
 #include <functional>
 #include <vector>
 
@@ -20,15 +21,16 @@ namespace ease {
 	// exponential curves
 	// ------------------
 	// https://github.com/jesusgollonet/ofpennereasing/blob/master/PennerEasing/Expo.cpp
+	// (exp2 rather than pow( 2, x ) - same curve, much cheaper)
 
 	inline float expoIn( float t )
 	{  // t is percent (0.-1.) of transition
-		return ( t == 0.0f ) ? 0.0f : pow( 2.0f, 10.0f * ( t - 1.0f ) );
+		return ( t == 0.0f ) ? 0.0f : std::exp2( 10.0f * ( t - 1.0f ) );
 	}
 
 	inline float expoOut( float t )
 	{
-		return ( t == 1.0f ) ? 1.0f : 1.0f - pow( 2.0f, -10.0f * t );
+		return ( t == 1.0f ) ? 1.0f : 1.0f - std::exp2( -10.0f * t );
 	}
 
 	inline float expoInOut( float t )
@@ -42,10 +44,10 @@ namespace ease {
 		}
 
 		if ( ( t /= 0.5f ) < 1.0f ) {
-			return 0.5f * pow( 2.0f, 10.0f * ( t - 1.0f ) );
+			return 0.5f * std::exp2( 10.0f * ( t - 1.0f ) );
 		}
 
-		return 0.5f * ( -pow( 2.0f, -10.0f * --t ) + 2.0f );
+		return 0.5f * ( -std::exp2( -10.0f * --t ) + 2.0f );
 	}
 
 	// cubic / quadratic curves
@@ -63,23 +65,27 @@ namespace ease {
 	// material design curves
 	// ----------------------
 	// https://material.io/design/motion/speed.html#easing
+	// (precomputed, see CubicBezierEase - cubicBezier() gives the same curves, more slowly)
 
 	// Material "standard ease" (decelerate in, accelerate out)
 	inline float material( float t )
 	{
-		return cubicBezier( t, 0.4f, 0.0f, 0.2f, 1.0f );
+		static const CubicBezierEase curve( 0.4f, 0.0f, 0.2f, 1.0f );
+		return curve( t );
 	}
 
 	// Material "accelerate" (e.g. exit screen)
 	inline float materialEnter( float t )
 	{
-		return cubicBezier( t, 0.0f, 0.0f, 0.2f, 1.0f );
+		static const CubicBezierEase curve( 0.0f, 0.0f, 0.2f, 1.0f );
+		return curve( t );
 	}
 
 	// Material "decelerate" (e.g. enter screen)
 	inline float materialExit( float t )
 	{
-		return cubicBezier( t, 0.4f, 0.0f, 1.0f, 1.0f );
+		static const CubicBezierEase curve( 0.4f, 0.0f, 1.0f, 1.0f );
+		return curve( t );
 	}
 }  // namespace ease
 
@@ -123,4 +129,146 @@ inline std::function<float( float )> easeFn( const EaseType& type )
 	}
 }
 
+namespace ease {
+
+	//
+	// easing functors - one empty type per EaseType, for use as a template parameter,
+	// so the curve inlines where it's applied, i.e.
+	//
+	//		ga::interpolate<ga::ease::ExpoOut>( a, b, pct );
+	//		ga::Tween<vec2, ga::ease::Material> tween;
+	//
+
+	struct Linear
+	{
+		static constexpr EaseType type = EaseType::LINEAR;
+		constexpr float operator()( float t ) const { return t; }
+	};
+	struct ExpoIn
+	{
+		static constexpr EaseType type = EaseType::EXPO_IN;
+		float operator()( float t ) const { return expoIn( t ); }
+	};
+	struct ExpoOut
+	{
+		static constexpr EaseType type = EaseType::EXPO_OUT;
+		float operator()( float t ) const { return expoOut( t ); }
+	};
+	struct ExpoInOut
+	{
+		static constexpr EaseType type = EaseType::EXPO_IN_OUT;
+		float operator()( float t ) const { return expoInOut( t ); }
+	};
+	struct CubeInQuadOut
+	{
+		static constexpr EaseType type = EaseType::CUBE_IN_QUAD_OUT;
+		float operator()( float t ) const { return cubeInQuadOut( t ); }
+	};
+	struct Material
+	{
+		static constexpr EaseType type = EaseType::MATERIAL;
+		float operator()( float t ) const { return material( t ); }
+	};
+	struct MaterialEnter
+	{
+		static constexpr EaseType type = EaseType::MATERIAL_ENTER;
+		float operator()( float t ) const { return materialEnter( t ); }
+	};
+	struct MaterialExit
+	{
+		static constexpr EaseType type = EaseType::MATERIAL_EXIT;
+		float operator()( float t ) const { return materialExit( t ); }
+	};
+
+}  // namespace ease
+
+// the functor type for an EaseType, i.e. EaseFunctor<EaseType::EXPO_OUT>::type is ease::ExpoOut
+// (CUSTOM has none - use a std::function, or your own functor)
+template <EaseType type>
+struct EaseFunctor;
+template <>
+struct EaseFunctor<EaseType::LINEAR>
+{
+	using type = ease::Linear;
+};
+template <>
+struct EaseFunctor<EaseType::EXPO_IN>
+{
+	using type = ease::ExpoIn;
+};
+template <>
+struct EaseFunctor<EaseType::EXPO_OUT>
+{
+	using type = ease::ExpoOut;
+};
+template <>
+struct EaseFunctor<EaseType::EXPO_IN_OUT>
+{
+	using type = ease::ExpoInOut;
+};
+template <>
+struct EaseFunctor<EaseType::CUBE_IN_QUAD_OUT>
+{
+	using type = ease::CubeInQuadOut;
+};
+template <>
+struct EaseFunctor<EaseType::MATERIAL>
+{
+	using type = ease::Material;
+};
+template <>
+struct EaseFunctor<EaseType::MATERIAL_ENTER>
+{
+	using type = ease::MaterialEnter;
+};
+template <>
+struct EaseFunctor<EaseType::MATERIAL_EXIT>
+{
+	using type = ease::MaterialExit;
+};
+
+// interpolate with the ease as a template parameter, i.e. interpolate<ease::ExpoOut>( a, b, pct )
+template <typename Ease, typename T>
+inline T interpolate( const T& a, const T& b, float pct, bool bClamp = false )
+{
+	pct = bClamp ? ga::clamp( Ease()( pct ), 0.f, 1.f ) : Ease()( pct );
+	return ga::lerp( a, b, pct );
+}
+
+// apply an ease by type, without a std::function - CUSTOM and unknown types are linear
+inline float applyEase( EaseType type, float t )
+{
+	using namespace ease;
+	switch ( type ) {
+		case EaseType::EXPO_IN:
+			return expoIn( t );
+		case EaseType::EXPO_OUT:
+			return expoOut( t );
+		case EaseType::EXPO_IN_OUT:
+			return expoInOut( t );
+		case EaseType::CUBE_IN_QUAD_OUT:
+			return cubeInQuadOut( t );
+		case EaseType::MATERIAL:
+			return material( t );
+		case EaseType::MATERIAL_ENTER:
+			return materialEnter( t );
+		case EaseType::MATERIAL_EXIT:
+			return materialExit( t );
+		case EaseType::LINEAR:
+		default:
+			return t;
+	}
+}
+
+// apply an ease function or functor - an empty std::function eases linearly
+inline float applyEaseFn( const EasingFn& easeFn, float t )
+{
+	return easeFn ? easeFn( t ) : t;
+}
+template <typename Ease>
+inline float applyEaseFn( const Ease& easeFn, float t )
+{
+	return easeFn( t );
+}
+
 }  // namespace ga
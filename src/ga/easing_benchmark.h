@@ -0,0 +1,52 @@
+#pragma once
+#include "ga/easing.h"
+#include "ga/timer.h"
+#include <iostream>
+
+namespace ga {
+
+// timing of the two easing paths, over the same samples
+struct EasingBenchmark
+{
+	size_t samples     = 0;
+	double functionMs  = 0.;  // interpolate( a, b, pct, std::function ) - the CUSTOM / default Tween path
+	double templatedMs = 0.;  // interpolate<Ease>( a, b, pct )
+	float checksum     = 0.f;  // keeps the optimizer from dropping the loops
+};
+
+inline std::ostream& operator<<( std::ostream& os, const EasingBenchmark& b )
+{
+	return os << b.samples << " samples - std::function: " << b.functionMs << " ms, templated: " << b.templatedMs << " ms ("
+	          << ( b.templatedMs > 0. ? b.functionMs / b.templatedMs : 0. ) << "x)";
+}
+
+// i.e. std::cout << ga::benchmarkEasing<ga::ease::ExpoOut>() << std::endl;
+template <typename Ease>
+EasingBenchmark benchmarkEasing( size_t samples = 1000000 )
+{
+	EasingBenchmark b;
+	b.samples = samples;
+	vec2 from( 0.f ), to( 100.f, 50.f );
+	float step = samples > 1 ? 1.f / ( samples - 1 ) : 0.f;
+
+	// as Tween<T> evaluates: a std::function, passed per call
+	EasingFn fn = easeFn( Ease::type );
+	auto start  = Clock::now();
+	vec2 sum( 0.f );
+	for ( size_t i = 0; i < samples; ++i ) {
+		sum += interpolate( from, to, i * step, fn, true );
+	}
+	b.functionMs = std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+
+	// as Tween<T, Ease> evaluates: the curve inlined
+	start = Clock::now();
+	for ( size_t i = 0; i < samples; ++i ) {
+		sum += interpolate<Ease>( from, to, i * step, true );
+	}
+	b.templatedMs = std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+
+	b.checksum = sum.x + sum.y;
+	return b;
+}
+
+}  // namespace ga
@@ -1,6 +1,7 @@
 #pragma once
 #include "ga/math.h"
 #include "ga/timer.h"
+#include <vector>
 
 namespace ga {
 
@@ -41,6 +42,8 @@ struct MouseEvent : public Event
 	Type type;
 	vec2 position;
 	int button;  // LEFT = 0, RIGHT = 1, CENTER = 2, ...
+
+	std::vector<vec2> history;  // positions of earlier MOVE / DRAG events coalesced into this one, oldest first
 };
 
 struct TouchEvent : public Event
@@ -54,15 +57,17 @@ struct TouchEvent : public Event
 	};
 
 	Type type;
+	int id = 0;         // pointer id, unique per touch while it is down
 	ga::vec2 position;  // window space
 	ga::vec2 size;
 	float angle;     // degrees 0-359
 	float pressure;  // 0-1024
 
+	std::vector<ga::vec2> history;  // positions of earlier DRAG events coalesced into this one, oldest first
+
 	/*
 	ofTouchEventArgs:
 	-----------------
-	int id;
 	int time;
 	int numTouches;
 	float minoraxis, majoraxis;
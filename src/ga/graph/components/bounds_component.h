@@ -1,5 +1,7 @@
 #pragma once
 #include "ga/graph/component.h"
+#include "ga/graph/node.h"
+#include "ga/graph/scene.h"
 #include "ga/math.h"
 #include <vector>
 
@@ -37,12 +39,39 @@ public:
 		}
 	}
 
+	// copies min / max only - scene registration belongs to the owner node
+	Bounds( const Bounds& other )
+	    : Component( other )
+	    , min( other.min )
+	    , max( other.max )
+	{
+	}
+
+	Bounds& operator=( const Bounds& other )
+	{
+		return set( other.min, other.max );
+	}
+
+	virtual ~Bounds()
+	{
+		setScene( nullptr );
+	}
+
+	inline Bounds& set( const vec3& min_, const vec3& max_ )
+	{
+		min = min_;
+		max = max_;
+		flagDirty();
+		return *this;
+	}
+
 	inline Bounds& include( vec3 pt )
 	{
 		for ( int i = 0; i < 3; ++i ) {
 			min[i] = std::min( pt[i], min[i] );
 			max[i] = std::max( pt[i], max[i] );
 		}
+		flagDirty();
 		return *this;
 	}
 
@@ -50,6 +79,18 @@ public:
 	{
 		min += delta;
 		max += delta;
+		flagDirty();
+		return *this;
+	}
+
+	// notify the owner node that min / max changed, so cached scene bounds are rebuilt
+	// (helpers call this, call it manually after setting min / max directly)
+	inline void flagDirty()
+	{
+		if ( auto node = getNode() ) {
+			node->flagTreeBoundsDirty();
+			node->flagSceneIndexDirty();
+		}
 	}
 
 	inline vec3 center() const
@@ -66,5 +107,25 @@ public:
 	{
 		return glm::all( glm::lessThanEqual( min, pos ) ) && glm::all( glm::greaterThanEqual( max, pos ) );
 	}
+
+protected:
+	friend class Scene;
+
+	// register with the scene's pick index
+	void setScene( std::shared_ptr<Scene> scene ) override
+	{
+		if ( auto prev = m_scene.lock() ) {
+			if ( prev == scene )
+				return;
+			prev->removePickable( this );
+		}
+		m_scene = scene;
+		if ( scene )
+			scene->addPickable( this );
+	}
+
+	std::weak_ptr<Scene> m_scene;
+	uint32_t m_pickIndex = 0;      // bvh item, set by the scene's pick index
+	bool m_isPickMoved   = false;  // queued for a refit
 };
 }  // namespace ga
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "ga/graph/components/timeline_component.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ga {
+
+// --- playhead
+
+void Timeline::addClip( double offsetSec, double durationSec, std::shared_ptr<TweenBase> tween, UpdateFn updateFn, DurationFn durationFn )
+{
+	if ( !tween )
+		return;
+
+	Clip clip;
+	clip.start      = std::max( offsetSec, 0. );
+	clip.end        = clip.start + std::max( durationSec, 0. );
+	clip.tween      = tween;
+	clip.updateFn   = updateFn;
+	clip.durationFn = durationFn;
+	m_clips.push_back( clip );
+
+	// re-sort the indices - layout is rare, seeking is frequent
+	auto index = ( uint32_t )m_clips.size() - 1;
+	if ( clip.durationFn )
+		m_sizedClips.push_back( index );
+	m_byStart.push_back( index );
+	m_byEnd.push_back( index );
+	std::stable_sort( m_byStart.begin(), m_byStart.end(), [this]( uint32_t a, uint32_t b ) { return m_clips[a].start < m_clips[b].start; } );
+	std::stable_sort( m_byEnd.begin(), m_byEnd.end(), [this]( uint32_t a, uint32_t b ) { return m_clips[a].end < m_clips[b].end; } );
+
+	// so seeking never allocates
+	m_active.reserve( m_clips.size() );
+	m_changed.reserve( m_clips.size() );
+
+	m_duration      = std::max( m_duration, clip.end );
+	m_isLayoutDirty = true;
+}
+
+bool Timeline::removeClip( std::shared_ptr<TweenBase> tween )
+{
+	auto it = std::find_if( m_clips.begin(), m_clips.end(), [&]( const Clip& clip ) { return clip.tween == tween; } );
+	if ( it == m_clips.end() )
+		return false;
+
+	auto clips = std::move( m_clips );
+	clips.erase( it );
+	clearClips();
+	for ( auto& clip : clips ) {
+		addClip( clip.start, clip.end - clip.start, clip.tween, clip.updateFn, clip.durationFn );
+	}
+	return true;
+}
+
+void Timeline::clearClips()
+{
+	m_clips.clear();
+	m_byStart.clear();
+	m_byEnd.clear();
+	m_active.clear();
+	m_changed.clear();
+	m_sizedClips.clear();
+	m_duration      = 0.;
+	m_playhead      = 0.;
+	m_direction     = 1.;
+	m_isLayoutDirty = true;
+}
+
+void Timeline::seek( double seconds )
+{
+	updateClipDurations();
+	seekTo( seconds );
+}
+
+// re-read the length of clips sized by their tween - a change re-lays out the timeline
+void Timeline::updateClipDurations()
+{
+	bool isChanged = false;
+	for ( auto index : m_sizedClips ) {
+		auto& clip = m_clips[index];
+		double end = clip.start + std::max( clip.durationFn(), 0. );
+		if ( end != clip.end ) {
+			clip.end  = end;
+			isChanged = true;
+		}
+	}
+	if ( !isChanged )
+		return;
+	std::stable_sort( m_byEnd.begin(), m_byEnd.end(), [this]( uint32_t a, uint32_t b ) { return m_clips[a].end < m_clips[b].end; } );
+	m_duration = 0.;
+	for ( auto& clip : m_clips ) {
+		m_duration = std::max( m_duration, clip.end );
+	}
+	m_isLayoutDirty = true;
+}
+
+void Timeline::seekTo( double seconds )
+{
+	seconds = ga::clamp( seconds, 0., m_duration );
+	seekFrom( m_playhead, seconds );
+	m_playhead = seconds;
+}
+
+void Timeline::updatePlayhead()
+{
+	auto now    = m_clock ? m_clock->now() : getFrameClock().now();
+	double step = 0.;
+	if ( m_isPlaying && m_lastPlayheadTime != TimePoint() )
+		step = std::chrono::duration<double>( now - m_lastPlayheadTime ).count() * m_rate * m_direction;
+	m_lastPlayheadTime = now;
+	updateClipDurations();
+
+	if ( step == 0. ) {
+		if ( m_isLayoutDirty )
+			seekTo( m_playhead );
+		return;
+	}
+
+	double t = m_playhead + step;
+	if ( m_duration <= 0. || m_loopMode == LoopMode::NONE ) {
+		seekTo( t );
+		if ( t >= m_duration || t <= 0. ) {
+			m_isPlaying = false;
+			onTimelineDone( this );
+		}
+		return;
+	}
+
+	if ( m_loopMode == LoopMode::LOOP ) {
+		if ( t >= m_duration ) {
+			// finish, then jump back to the start
+			seekTo( m_duration );
+			seekTo( 0. );
+			t = std::fmod( t, m_duration );
+		} else if ( t < 0. ) {
+			seekTo( 0. );
+			seekTo( m_duration );
+			t = m_duration + std::fmod( t, m_duration );
+		}
+		seekTo( t );
+		return;
+	}
+
+	// ping pong - bounce off either end (a huge step bounces at most twice)
+	for ( int i = 0; i < 2 && ( t > m_duration || t < 0. ); ++i ) {
+		double edge = t > m_duration ? m_duration : 0.;
+		seekTo( edge );
+		t           = std::fmod( t - edge, 2. * m_duration );
+		t           = edge - t;
+		m_direction = -m_direction;
+	}
+	seekTo( t );
+}
+
+// move the playhead, applying only the clips whose state changes, or that the playhead is inside
+void Timeline::seekFrom( double from, double to )
+{
+	++m_seekCount;
+	m_changed.clear();
+	auto addChanged = [this]( uint32_t index ) {
+		if ( m_clips[index].stamp != m_seekCount ) {
+			m_clips[index].stamp = m_seekCount;
+			m_changed.push_back( index );
+		}
+	};
+
+	if ( m_isLayoutDirty ) {
+		for ( uint32_t i = 0; i < m_clips.size(); ++i ) {
+			addChanged( i );
+		}
+		m_isLayoutDirty = false;
+	} else {
+		// clips starting or ending between 'from' and 'to' - binary searched
+		double lo = std::min( from, to );
+		double hi = std::max( from, to );
+
+		auto startsBefore = [this]( uint32_t index, double t ) { return m_clips[index].start < t; };
+		auto endsBefore   = [this]( uint32_t index, double t ) { return m_clips[index].end < t; };
+		for ( auto it = std::lower_bound( m_byStart.begin(), m_byStart.end(), lo, startsBefore ); it != m_byStart.end() && m_clips[*it].start <= hi; ++it ) {
+			addChanged( *it );
+		}
+		for ( auto it = std::lower_bound( m_byEnd.begin(), m_byEnd.end(), lo, endsBefore ); it != m_byEnd.end() && m_clips[*it].end <= hi; ++it ) {
+			addChanged( *it );
+		}
+		// and clips the playhead was inside
+		for ( auto index : m_active ) {
+			addChanged( index );
+		}
+	}
+
+	// apply clips the playhead is before, then after, then inside -
+	// so when clips animate the same value, the one that should win is applied last
+	auto phase = [&]( const Clip& clip ) { return to < clip.start ? 0 : ( to >= clip.end ? 1 : 2 ); };
+
+	// a clip the playhead moved back before writes its start value, over whatever a finished clip
+	// left on the same target - targets aren't known here, so re-apply every finished clip after it
+	// (only seeks back across a clip's start pay for this)
+	bool isRewound = std::any_of( m_changed.begin(), m_changed.end(), [&]( uint32_t index ) {
+		return phase( m_clips[index] ) == 0 && from >= m_clips[index].start;
+	} );
+	if ( isRewound ) {
+		for ( auto it = m_byEnd.begin(); it != m_byEnd.end() && m_clips[*it].end <= to; ++it ) {
+			addChanged( *it );
+		}
+	}
+
+	std::sort( m_changed.begin(), m_changed.end(), [&]( uint32_t a, uint32_t b ) {
+		auto& ca   = m_clips[a];
+		auto& cb   = m_clips[b];
+		int phaseA = phase( ca );
+		int phaseB = phase( cb );
+		if ( phaseA != phaseB )
+			return phaseA < phaseB;
+		if ( phaseA == 0 )
+			return ca.start > cb.start;  // earliest start wins
+		if ( phaseA == 1 )
+			return ca.end < cb.end;  // latest end wins
+		return ca.start < cb.start;  // latest start wins
+	} );
+
+	m_active.clear();
+	for ( auto index : m_changed ) {
+		applyClip( index, to );
+		if ( phase( m_clips[index] ) == 2 )
+			m_active.push_back( index );
+	}
+}
+
+void Timeline::applyClip( uint32_t index, double time )
+{
+	auto& clip = m_clips[index];
+	double pct = clip.end > clip.start ? ( time - clip.start ) / ( clip.end - clip.start ) : ( time >= clip.start ? 1. : 0. );
+	clip.tween->seek_( ga::clamp( ( float )pct, 0.f, 1.f ) );
+	if ( clip.updateFn )
+		clip.updateFn( clip.tween );
+}
+
+}  // namespace ga
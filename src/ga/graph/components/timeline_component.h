@@ -1,7 +1,12 @@
 #pragma once
 #include "ga/graph/component.h"
+#include "ga/keyframes.h"
+#include "ga/path.h"
+#include "ga/pool.h"
 #include "ga/signal.h"
+#include "ga/small_function.h"
 #include "ga/tween.h"
+#include "ga/tween_group.h"
 #include <map>
 
 namespace ga {
@@ -12,7 +17,10 @@ class Timeline : public virtual Component
 public:
 	void update() override
 	{
-		std::vector<std::shared_ptr<TweenBase>> deleteKeys;
+		if ( !m_clips.empty() )
+			updatePlayhead();
+
+		m_deleteKeys.clear();
 		for ( auto& el : m_tweenRefMap ) {
 			auto& tween    = el.first;
 			auto& updateFn = el.second;
@@ -27,13 +35,14 @@ public:
 				}
 			}
 			if ( !keep ) {
-				deleteKeys.push_back( tween );
+				m_deleteKeys.push_back( tween );
 			}
 		}
 		bool wasEmpty = m_tweenRefMap.empty();
-		for ( auto& key : deleteKeys ) {
+		for ( auto& key : m_deleteKeys ) {
 			m_tweenRefMap.erase( key );
 		}
+		m_deleteKeys.clear();
 		bool isEmpty = m_tweenRefMap.empty();
 		if ( !wasEmpty && isEmpty ) {
 			onTimelineDone( this );
@@ -42,47 +51,105 @@ public:
 		}
 	}
 
-	template <typename T, typename Fn>
-	void add( std::shared_ptr<Tween<T>> tween, Fn updateFn = nullptr )
+	template <typename T, typename Ease, typename Fn>
+	void add( std::shared_ptr<Tween<T, Ease>> tween, Fn updateFn = nullptr )
 	{
+		if ( m_clock )
+			tween->setClock( m_clock );
 		if ( updateFn ) {
-			m_tweenRefMap[tween] = [updateFn]( std::shared_ptr<TweenBase> t ) { updateFn( std::static_pointer_cast<Tween<T>>( t )->getValue() ); };
+			m_tweenRefMap[tween] = [updateFn]( std::shared_ptr<TweenBase> t ) { updateFn( std::static_pointer_cast<Tween<T, Ease>>( t )->getValue() ); };
 		} else {
 			m_tweenRefMap[tween] = nullptr;
 		}
 	}
 
-	template <typename T>
-	void add( std::shared_ptr<Tween<T>> tween, std::function<void( const T& )> updateFn = nullptr )
+	template <typename T, typename Ease>
+	void add( std::shared_ptr<Tween<T, Ease>> tween, std::function<void( const T& )> updateFn = nullptr )
 	{
+		if ( m_clock )
+			tween->setClock( m_clock );
 		if ( updateFn ) {
-			m_tweenRefMap[tween] = [updateFn]( std::shared_ptr<TweenBase> t ) { updateFn( std::static_pointer_cast<Tween<T>>( t )->getValue() ); };
+			m_tweenRefMap[tween] = [updateFn]( std::shared_ptr<TweenBase> t ) { updateFn( std::static_pointer_cast<Tween<T, Ease>>( t )->getValue() ); };
 		} else {
 			m_tweenRefMap[tween] = nullptr;
 		}
 	}
 
+	// fire-and-forget tweens - pooled, with their callbacks stored inline when small enough,
+	// so a steady churn of them (i.e. hover effects) doesn't allocate
 	template <typename T, typename Fn>
-	std::shared_ptr<Tween<T>> add( const T& startVal, const T& endVal, std::function<float( float )> easeFn, Fn updateFn = nullptr, std::function<void()> onDone = nullptr )
+	std::shared_ptr<Tween<T>> add( const T& startVal, const T& endVal, std::function<float( float )> easeFn, Fn updateFn = nullptr, Callback onDone = nullptr )
 	{
-		auto tween = std::make_shared<Tween<T>>( startVal, endVal, easeFn, onDone );
-		this->add( tween, std::function<void( const T& )>( updateFn ) );
+		auto tween = std::allocate_shared<Tween<T>>( PoolAllocator<Tween<T>>(), startVal, endVal, easeFn, std::move( onDone ) );
+		if ( m_clock )
+			tween->setClock( m_clock );
+		m_tweenRefMap[tween] = makeUpdateFn<Tween<T>>( std::move( updateFn ) );
 		return tween;
 	}
 
 	template <typename T>
-	std::shared_ptr<Tween<T>> add( const T& startVal, const T& endVal, std::function<float( float )> easeFn, std::function<void( const T& )> updateFn = nullptr, std::function<void()> onDone = nullptr )
+	std::shared_ptr<Tween<T>> add( const T& startVal, const T& endVal, std::function<float( float )> easeFn, std::function<void( const T& )> updateFn = nullptr, Callback onDone = nullptr )
 	{
-		auto tween = std::make_shared<Tween<T>>( startVal, endVal, easeFn, onDone );
+		return this->add<T, std::function<void( const T& )>>( startVal, endVal, easeFn, std::move( updateFn ), std::move( onDone ) );
+	}
+
+	// keyframe tweens
+	template <typename T, typename Fn>
+	void add( std::shared_ptr<KeyframeTween<T>> tween, Fn updateFn = nullptr )
+	{
+		this->add( tween, std::function<void( const T& )>( updateFn ) );
+	}
+
+	template <typename T>
+	void add( std::shared_ptr<KeyframeTween<T>> tween, std::function<void( const T& )> updateFn = nullptr )
+	{
+		if ( m_clock )
+			tween->setClock( m_clock );
+		if ( updateFn ) {
+			m_tweenRefMap[tween] = [updateFn]( std::shared_ptr<TweenBase> t ) { updateFn( std::static_pointer_cast<KeyframeTween<T>>( t )->getValue() ); };
+		} else {
+			m_tweenRefMap[tween] = nullptr;
+		}
+	}
+
+	// a new tween playing a (shared) track
+	template <typename T, typename Fn>
+	std::shared_ptr<KeyframeTween<T>> add( std::shared_ptr<const KeyframeTrack<T>> track, Fn updateFn = nullptr, std::function<void()> onDone = nullptr )
+	{
+		return this->add( track, std::function<void( const T& )>( updateFn ), onDone );
+	}
+
+	template <typename T>
+	std::shared_ptr<KeyframeTween<T>> add( std::shared_ptr<const KeyframeTrack<T>> track, std::function<void( const T& )> updateFn = nullptr, std::function<void()> onDone = nullptr )
+	{
+		auto tween = std::make_shared<KeyframeTween<T>>( track, onDone );
 		this->add( tween, updateFn );
 		return tween;
 	}
 
-	template <typename T>
-	bool setTweenUpdate( std::shared_ptr<Tween<T>> tween, std::function<void( const T& )> updateFn )
+	// tween groups
+	template <typename T, typename Ease>
+	void add( std::shared_ptr<TweenGroup<T, Ease>> group )
+	{
+		if ( m_clock )
+			group->setClock( m_clock );
+		m_tweenRefMap[group] = nullptr;
+	}
+
+	// path tweens
+	template <typename T, typename Ease, typename Fn = std::nullptr_t>
+	void add( std::shared_ptr<PathTween<T, Ease>> tween, Fn updateFn = nullptr )
+	{
+		if ( m_clock )
+			tween->setClock( m_clock );
+		m_tweenRefMap[tween] = makeUpdateFn<PathTween<T, Ease>>( std::function<void( const T& )>( updateFn ) );
+	}
+
+	template <typename T, typename Ease>
+	bool setTweenUpdate( std::shared_ptr<Tween<T, Ease>> tween, std::function<void( const T& )> updateFn )
 	{
 		try {
-			m_tweenRefMap.at( tween ) = [updateFn]( std::shared_ptr<TweenBase> t ) { updateFn( std::static_pointer_cast<Tween<T>>( t )->getValue() ); };
+			m_tweenRefMap.at( tween ) = [updateFn]( std::shared_ptr<TweenBase> t ) { updateFn( std::static_pointer_cast<Tween<T, Ease>>( t )->getValue() ); };
 			return true;
 		} catch ( ... ) {
 			return false;
@@ -92,6 +159,7 @@ public:
 	void clear()
 	{
 		m_tweenRefMap.clear();
+		clearClips();
 	}
 
 	std::vector<std::shared_ptr<TweenBase>> getTweens()
@@ -106,12 +174,136 @@ public:
 
 	bool isActive()
 	{
-		return m_tweenRefMap.size();
+		return m_tweenRefMap.size() || ( m_isPlaying && !m_clips.empty() );
+	}
+
+	// ------------------------------------------------------------------------
+	// playhead
+	// tweens laid out at offsets on the timeline's own time, instead of running
+	// on their timers - the playhead plays at a rate (negative for reverse),
+	// and can be seeked anywhere, in O(log n) of the number of tweens.
+	// laid out tweens stay until removed, and don't fire onDone callbacks.
+	// tweens may animate the same value - the one the playhead is inside wins,
+	// then the last to finish, then the first to start.
+	// ------------------------------------------------------------------------
+
+	enum class LoopMode
+	{
+		NONE,
+		LOOP,
+		PING_PONG
+	};
+
+	template <typename T, typename Ease, typename Fn = std::nullptr_t>
+	void addAt( double offsetSec, double durationSec, std::shared_ptr<Tween<T, Ease>> tween, Fn updateFn = nullptr )
+	{
+		addClip( offsetSec, durationSec, tween, makeUpdateFn<Tween<T, Ease>>( std::function<void( const T& )>( updateFn ) ) );
 	}
 
+	// keyframe tweens default to their track's duration
+	template <typename T, typename Fn = std::nullptr_t>
+	void addAt( double offsetSec, std::shared_ptr<KeyframeTween<T>> tween, Fn updateFn = nullptr )
+	{
+		auto duration = tween->getTrack() ? tween->getTrack()->getDuration() : 0.;
+		addClip( offsetSec, duration, tween, makeUpdateFn<KeyframeTween<T>>( std::function<void( const T& )>( updateFn ) ) );
+	}
+
+	// the group's length is re-read on every seek, so it can be added before all its targets are
+	template <typename T, typename Ease>
+	void addAt( double offsetSec, std::shared_ptr<TweenGroup<T, Ease>> group )
+	{
+		auto groupPtr = group.get();  // the clip keeps the group alive
+		addClip( offsetSec, group->getTotalDuration() * .001, group, nullptr, [groupPtr]() { return groupPtr->getTotalDuration() * .001; } );
+	}
+
+	template <typename T, typename Ease, typename Fn = std::nullptr_t>
+	void addAt( double offsetSec, double durationSec, std::shared_ptr<PathTween<T, Ease>> tween, Fn updateFn = nullptr )
+	{
+		addClip( offsetSec, durationSec, tween, makeUpdateFn<PathTween<T, Ease>>( std::function<void( const T& )>( updateFn ) ) );
+	}
+
+	bool removeClip( std::shared_ptr<TweenBase> tween );
+	void clearClips();
+
+	void seek( double seconds );
+	double getPlayhead() const { return m_playhead; }
+	double getDuration() const { return m_duration; }  // end of the last laid out tween (group lengths as of the last seek)
+
+	void play() { m_isPlaying = true; }
+	void pause() { m_isPlaying = false; }
+	bool isPlaying() const { return m_isPlaying; }
+
+	void setRate( double rate ) { m_rate = rate; }  // 1 = real time, negative plays in reverse
+	double getRate() const { return m_rate; }
+
+	void setLoopMode( LoopMode mode )
+	{
+		m_loopMode  = mode;
+		m_direction = 1.;
+	}
+	LoopMode getLoopMode() const { return m_loopMode; }
+
+	// when set, tweens added from then on are timed with this clock (see Timer::setClock)
+	void setClock( FrameClock* clock ) { m_clock = clock; }
+	FrameClock* getClock() const { return m_clock; }
+
 	ga::Signal<Timeline*> onTimelineStart, onTimelineDone;
 
 protected:
-	std::map<std::shared_ptr<TweenBase>, std::function<void( std::shared_ptr<TweenBase> )>> m_tweenRefMap;
+	using UpdateFn   = SmallFunction<void( std::shared_ptr<TweenBase> )>;
+	using DurationFn = SmallFunction<double()>;
+
+	struct Clip
+	{
+		double start, end;
+		std::shared_ptr<TweenBase> tween;
+		UpdateFn updateFn;
+		DurationFn durationFn;  // for clips sized by their tween (i.e. groups), re-read before seeking
+		uint64_t stamp = 0;     // last seek that applied it
+	};
+
+	// wraps a callback taking the tween's value
+	template <typename TweenT, typename Fn>
+	static UpdateFn makeUpdateFn( Fn updateFn )
+	{
+		if ( isEmptyCallable( updateFn ) )
+			return nullptr;
+		return [updateFn]( std::shared_ptr<TweenBase> t ) { updateFn( static_cast<TweenT*>( t.get() )->getValue() ); };
+	}
+	template <typename TweenT>
+	static UpdateFn makeUpdateFn( std::nullptr_t )
+	{
+		return nullptr;
+	}
+
+	void addClip( double offsetSec, double durationSec, std::shared_ptr<TweenBase> tween, UpdateFn updateFn, DurationFn durationFn = nullptr );
+	void updateClipDurations();
+	void updatePlayhead();
+	void seekTo( double seconds );  // seek(), without updating clip durations
+	void seekFrom( double from, double to );
+	void applyClip( uint32_t index, double time );
+
+	using TweenRefMap = std::map<std::shared_ptr<TweenBase>, UpdateFn, std::less<std::shared_ptr<TweenBase>>,
+	                             PoolAllocator<std::pair<const std::shared_ptr<TweenBase>, UpdateFn>>>;  // pooled nodes
+
+	TweenRefMap m_tweenRefMap;
+	std::vector<std::shared_ptr<TweenBase>> m_deleteKeys;  // finished tweens (scratch, reused every update)
+	FrameClock* m_clock = nullptr;
+
+	// playhead
+	std::vector<Clip> m_clips;
+	std::vector<uint32_t> m_byStart, m_byEnd;  // clip indices, sorted by start / end time
+	std::vector<uint32_t> m_active;            // clips the playhead is inside
+	std::vector<uint32_t> m_changed;           // clips to apply in a seek (scratch)
+	std::vector<uint32_t> m_sizedClips;        // clips with a durationFn
+	double m_playhead    = 0.;
+	double m_duration    = 0.;
+	double m_rate        = 1.;
+	double m_direction   = 1.;  // -1 on the way back, when ping-ponging
+	LoopMode m_loopMode  = LoopMode::NONE;
+	bool m_isPlaying     = true;
+	bool m_isLayoutDirty = true;  // apply every clip on the next seek
+	uint64_t m_seekCount = 0;
+	TimePoint m_lastPlayheadTime;
 };
 }  // namespace ga
\ No newline at end of file
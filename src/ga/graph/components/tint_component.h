@@ -2,6 +2,8 @@
 #include "ga/color.h"
 #include "ga/render.h"
 #include "ga/graph/component.h"
+#include "ga/graph/node.h"
+#include "ga/property.h"
 
 namespace ga {
 
@@ -34,4 +36,10 @@ protected:
 	Color m_pGlobalColor;
 };
 
+// a node's tint color as a tween target - invalid if the node has no Tint
+inline Property<Color> getTintProperty( const std::shared_ptr<Node>& node )
+{
+	return node ? Property<Color>::field( node->getComponent<Tint>(), &Tint::color ) : Property<Color>();
+}
+
 }  // namespace ga
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "ga/graph/components/bounds_component.h"
 #include "ga/graph/node.h"
 #include "ga/graph/scene.h"
+#include "ga/render.h"
 #include "ga/signal.h"
 namespace ga {
 
@@ -28,9 +29,14 @@ public:
 		} type;
 
 		TouchZone* touchZone;   // source zone (this)
-		TouchEvent touchEvent;  // raw event
+		TouchEvent touchEvent;  // raw event, without its history (see below)
 		vec3 localPosition;     // local touch position
 		vec3 scenePosition;
+
+		// the raw event's coalesced positions, oldest first - not copied per zone,
+		// only valid during the callback
+		const vec2* history = nullptr;
+		size_t historySize  = 0;
 	};
 
 	void handleTouchEvent( ga::TouchEvent& touchEvt )
@@ -48,16 +54,35 @@ public:
 
 		// transform touchEvt position into local node position
 		TouchZone::Event event;
+		auto history        = std::move( touchEvt.history );  // point at the history instead of copying it per zone
 		event.touchZone     = this;
 		event.touchEvent    = touchEvt;
+		touchEvt.history    = std::move( history );
+		event.history       = touchEvt.history.data();
+		event.historySize   = touchEvt.history.size();
 		event.scenePosition = ga::vec3( touchEvt.position.x, touchEvt.position.y, 0 );
 		event.localPosition = node->scenePosToLocal( vec3( touchEvt.position, 0 ) );
-		bool isInBounds     = m_customBoundsTest
-		                          ? m_customBoundsTest( event )
-		                          : node->component<Bounds>().contains( event.localPosition );  // todo: 3D bounds / ray cast...
+		bool isInBounds     = false;
+		if ( m_customBoundsTest ) {
+			isInBounds = m_customBoundsTest( event );
+		} else if ( m_useRayCast && getRenderer().getViewport().area() > 0.f ) {
+			// 3D - intersect the touch ray with the oriented bounds
+			float t;
+			auto ray = getRenderer().windowPosToRay( touchEvt.position );
+			vec3 localPos;
+			isInBounds = node->intersectRay( ray, t, localPos );
+			if ( isInBounds ) {
+				event.scenePosition = ray.at( t );
+				event.localPosition = localPos;
+			}
+		} else {
+			isInBounds = node->component<Bounds>().contains( event.localPosition );
+		}
 		if ( m_boundsInverted )
 			isInBounds = !isInBounds;  // e.g. for click-off
 
+		bool isActive = isActiveFor( touchEvt.id );
+
 		switch ( touchEvt.type ) {
 			case TouchEvent::Type::PRESS: {
 				if ( isInBounds ) {
@@ -65,7 +90,7 @@ public:
 						touchEvt.captured = true;
 					}
 					// tap on
-					setState( State::ACTIVE );
+					addPointer( touchEvt.id );
 					event.type = TouchZone::Event::Type::PRESS;
 					onTouchEvent( event );
 				}
@@ -77,19 +102,18 @@ public:
 					if ( m_isCapturingTouch ) {
 						touchEvt.captured = true;
 					}
-					if ( getState() == State::ACTIVE ) {
+					if ( isActive ) {
 						// dragged within bounds
 						event.type = TouchZone::Event::Type::DRAG_INSIDE;
 					} else {
 						// drag into zone
-						// setState( State::ACTIVE );
 						event.type = TouchZone::Event::Type::DRAG_INTO;
 					}
 					onTouchEvent( event );
-				} else if ( getState() == State::ACTIVE ) {
+				} else if ( isActive ) {
 					// drag off of zone
 					if ( m_allowLosingFocus ) {
-						setState( State::INACTIVE );
+						removePointer( touchEvt.id );
 					}
 					event.type = TouchZone::Event::Type::DRAG_OFF;
 					onTouchEvent( event );
@@ -98,34 +122,66 @@ public:
 			}
 
 			case ga::TouchEvent::Type::RELEASE: {
-				if ( getState() == State::ACTIVE ) {
+				// only the touch that activated this zone can release it
+				if ( isActive ) {
 					// tap release
 					if ( m_isCapturingTouch ) {
 						touchEvt.captured = true;
 					}
-					setState( State::INACTIVE );
+					removePointer( touchEvt.id );
 					event.type = TouchZone::Event::Type::RELEASE;
 					onTouchEvent( event );
-				} else {
-					setState( State::INACTIVE );
 				}
 				break;
 			}
 
 			case ga::TouchEvent::Type::CANCEL: {
-				// not sure how to handle this...
-				if ( m_isCapturingTouch ) {
-					touchEvt.captured = true;
+				if ( isActive ) {
+					if ( m_isCapturingTouch ) {
+						touchEvt.captured = true;
+					}
+					removePointer( touchEvt.id );
 				}
-				setState( State::INACTIVE );
 				break;
 			}
 		}
 	}
 
+	// true if the touch with this pointer id pressed this zone, and is still down
+	bool isActiveFor( int pointerId ) const
+	{
+		return std::find( m_activePointers.begin(), m_activePointers.end(), pointerId ) != m_activePointers.end();
+	}
+
+	const std::vector<int>& getActivePointers() const { return m_activePointers; }
+
+	// test touches with a ray through the Renderer's VIEW / PROJECTION matrices and viewport (see Renderer::windowPosToRay),
+	// against the owner node's Bounds as an oriented box - for zones that are rotated in 3D
+	// (falls back to the 2D bounds test until Renderer::setViewport() is called)
+	inline void setUseRayCast( bool useRayCast = true )
+	{
+		m_useRayCast = useRayCast;
+		flagTouchIndexDirty();
+	}
+
+	inline bool getIsUsingRayCast() const
+	{
+		return m_useRayCast;
+	}
+
+	// ACTIVE while any touch is down on the zone - setting INACTIVE or DISABLED releases all touches
 	void setState( State state )
 	{
+		if ( state != State::ACTIVE ) {
+			while ( !m_activePointers.empty() ) {
+				removePointer( m_activePointers.back() );
+			}
+		}
+		if ( m_state == state )
+			return;
 		m_state = state;
+		if ( auto scene = m_scene.lock() )
+			scene->setTouchZoneActive( this, m_state == State::ACTIVE );
 	}
 	State getState() const
 	{
@@ -135,13 +191,13 @@ public:
 	inline void enable()
 	{
 		if ( m_state == State::DISABLED ) {
-			m_state = State::INACTIVE;
+			setState( State::INACTIVE );
 		}
 	}
 
 	inline void disable()
 	{
-		m_state = State::DISABLED;
+		setState( State::DISABLED );
 	}
 
 	inline void setAllowLosingFocus( bool isAllowed = true )
@@ -162,6 +218,7 @@ public:
 	inline void invertBounds( bool invert = true )
 	{
 		m_boundsInverted = invert;
+		flagTouchIndexDirty();
 	}
 
 	inline bool getAreBoundsInverted() const
@@ -172,12 +229,14 @@ public:
 	inline void setCustomBoundsTest( std::function<bool( TouchZone::Event )> testFn )
 	{
 		m_customBoundsTest = testFn;
+		flagTouchIndexDirty();
 	}
 
 	// will test against ga::Bounds component attached to owner node
 	inline void setUseDefaultBoundsTest()
 	{
 		m_customBoundsTest = nullptr;
+		flagTouchIndexDirty();
 	}
 
 	inline bool getIsUsingCustomBoundsTest() const
@@ -185,16 +244,34 @@ public:
 		return m_customBoundsTest != nullptr;
 	}
 
-	void connectTouch( std::shared_ptr<Scene> scene, int groupId )
+	// register with the scene's touch index
+	// (Scene::handleTouchEvent only dispatches to zones under the touch, or already active)
+	// zones in lower groups get touches first, then top-most (last drawn) first within a group
+	void connectTouch( std::shared_ptr<Scene> scene, int groupId = 0 )
 	{
+		disconnectTouch();
+		m_touchGroup = groupId;
 		if ( !scene )
 			return;
-		m_touchConnection = scene->onTouchEvent.connect_scoped( [this]( TouchEvent& te ) { handleTouchEvent( te ); }, groupId );
+		m_scene = scene;
+		scene->addTouchZone( this );
+	}
+
+	int getTouchGroup() const
+	{
+		return m_touchGroup;
 	}
 
 	void disconnectTouch()
 	{
-		m_touchConnection.disconnect();
+		if ( auto scene = m_scene.lock() )
+			scene->removeTouchZone( this );
+		m_scene.reset();
+	}
+
+	virtual ~TouchZone()
+	{
+		disconnectTouch();
 	}
 
 	// signals
@@ -203,15 +280,50 @@ public:
 protected:
 	virtual void setScene( std::shared_ptr<Scene> scene )
 	{
-		disconnectTouch();
-		connectTouch( scene, 0 );
+		connectTouch( scene, m_touchGroup );
+	}
+
+	// per-touch state - capturing zones also own the touch in the scene's pointer table,
+	// so its DRAG / RELEASE events come straight here without a hit test
+	void addPointer( int pointerId )
+	{
+		if ( !isActiveFor( pointerId ) ) {
+			m_activePointers.push_back( pointerId );
+			if ( m_isCapturingTouch ) {
+				if ( auto scene = m_scene.lock() )
+					scene->setTouchOwner( pointerId, this );
+			}
+		}
+		setState( State::ACTIVE );
+	}
+
+	void removePointer( int pointerId )
+	{
+		auto it = std::find( m_activePointers.begin(), m_activePointers.end(), pointerId );
+		if ( it == m_activePointers.end() )
+			return;
+		m_activePointers.erase( it );
+		if ( auto scene = m_scene.lock() )
+			scene->clearTouchOwner( pointerId, this );
+		if ( m_activePointers.empty() )
+			setState( State::INACTIVE );
+	}
+
+	// options that change whether a zone can be found by its bounds
+	void flagTouchIndexDirty()
+	{
+		if ( auto scene = m_scene.lock() )
+			scene->flagTouchIndexDirty();
 	}
 
-	State m_state;
-	ga::Connection m_touchConnection;
+	State m_state = State::INACTIVE;
+	std::vector<int> m_activePointers;  // ids of touches down on this zone
+	std::weak_ptr<Scene> m_scene;
+	int m_touchGroup                                           = 0;
 	bool m_boundsInverted                                      = false;
 	bool m_isCapturingTouch                                    = true;
 	bool m_allowLosingFocus                                    = false;
+	bool m_useRayCast                                          = false;
 	std::function<bool( TouchZone::Event )> m_customBoundsTest = nullptr;
 };
 }  // namespace ga
@@ -0,0 +1,244 @@
+#include "ga/graph/input_log.h"
+#include "ga/graph/scene.h"
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace ga {
+
+namespace {
+	const char s_magic[4]    = { 'G', 'A', 'I', 'L' };
+	const uint32_t s_version = 1;
+
+	template <typename T>
+	void writeValue( std::ostream& stream, const T& value )
+	{
+		stream.write( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+	}
+
+	template <typename T>
+	bool readValue( std::istream& stream, T& value )
+	{
+		return ( bool )stream.read( reinterpret_cast<char*>( &value ), sizeof( T ) );
+	}
+}  // namespace
+
+KeyEvent RecordedInput::toKeyEvent() const
+{
+	KeyEvent e;
+	e.type = ( KeyEvent::Type )type;
+	e.key  = code;
+	return e;
+}
+
+MouseEvent RecordedInput::toMouseEvent() const
+{
+	MouseEvent e;
+	e.type     = ( MouseEvent::Type )type;
+	e.button   = code;
+	e.position = position;
+	return e;
+}
+
+TouchEvent RecordedInput::toTouchEvent() const
+{
+	TouchEvent e;
+	e.type     = ( TouchEvent::Type )type;
+	e.id       = code;
+	e.position = position;
+	e.size     = size;
+	e.angle    = angle;
+	e.pressure = pressure;
+	return e;
+}
+
+// --- log format
+
+bool writeInputLogHeader( std::ostream& stream )
+{
+	stream.write( s_magic, sizeof( s_magic ) );
+	writeValue( stream, s_version );
+	return ( bool )stream;
+}
+
+void writeInput( std::ostream& stream, const RecordedInput& input )
+{
+	writeValue( stream, input.device );
+	writeValue( stream, input.type );
+	writeValue( stream, input.timeMicros );
+	writeValue( stream, input.code );
+	switch ( input.device ) {
+		case RecordedInput::Device::KEY:
+			break;
+		case RecordedInput::Device::MOUSE:
+			writeValue( stream, input.position );
+			break;
+		case RecordedInput::Device::TOUCH:
+			writeValue( stream, input.position );
+			writeValue( stream, input.size );
+			writeValue( stream, input.angle );
+			writeValue( stream, input.pressure );
+			break;
+	}
+}
+
+bool readInputLog( std::istream& stream, std::vector<RecordedInput>& inputs )
+{
+	char magic[4];
+	uint32_t version;
+	if ( !stream.read( magic, sizeof( magic ) ) || std::memcmp( magic, s_magic, sizeof( magic ) ) != 0 || !readValue( stream, version ) ||
+	     version != s_version ) {
+		std::cerr << "readInputLog() - not an input log, or unsupported version" << std::endl;
+		return false;
+	}
+
+	RecordedInput input;
+	while ( readValue( stream, input.device ) ) {
+		bool ok = readValue( stream, input.type ) && readValue( stream, input.timeMicros ) && readValue( stream, input.code );
+		if ( ok && input.device == RecordedInput::Device::MOUSE ) {
+			ok = readValue( stream, input.position );
+		} else if ( ok && input.device == RecordedInput::Device::TOUCH ) {
+			ok = readValue( stream, input.position ) && readValue( stream, input.size ) && readValue( stream, input.angle ) &&
+			     readValue( stream, input.pressure );
+		} else if ( ok && input.device != RecordedInput::Device::KEY ) {
+			ok = false;
+		}
+		if ( !ok ) {
+			std::cerr << "readInputLog() - log is truncated or corrupt after " << inputs.size() << " events" << std::endl;
+			return false;
+		}
+		inputs.push_back( input );
+	}
+	return true;
+}
+
+// --- InputRecorder
+
+bool InputRecorder::start( std::shared_ptr<Scene> scene, const std::string& path )
+{
+	stop();
+	if ( !scene )
+		return false;
+
+	m_stream.open( path, std::ios::binary | std::ios::trunc );
+	if ( !m_stream.is_open() || !writeInputLogHeader( m_stream ) ) {
+		std::cerr << "InputRecorder::start() - can't write to " << path << std::endl;
+		m_stream.close();
+		return false;
+	}
+	m_startTime   = Clock::now();
+	m_numRecorded = 0;
+
+	m_connections.emplace_back( scene->onKeyInput.connect( [this]( KeyEvent& e ) {
+		RecordedInput input;
+		input.device = RecordedInput::Device::KEY;
+		input.type   = ( uint8_t )e.type;
+		input.code   = e.key;
+		record( input, e.time );
+	} ) );
+	m_connections.emplace_back( scene->onMouseInput.connect( [this]( MouseEvent& e ) {
+		RecordedInput input;
+		input.device   = RecordedInput::Device::MOUSE;
+		input.type     = ( uint8_t )e.type;
+		input.code     = e.button;
+		input.position = e.position;
+		record( input, e.time );
+	} ) );
+	m_connections.emplace_back( scene->onTouchInput.connect( [this]( TouchEvent& e ) {
+		RecordedInput input;
+		input.device   = RecordedInput::Device::TOUCH;
+		input.type     = ( uint8_t )e.type;
+		input.code     = e.id;
+		input.position = e.position;
+		input.size     = e.size;
+		input.angle    = e.angle;
+		input.pressure = e.pressure;
+		record( input, e.time );
+	} ) );
+	return true;
+}
+
+void InputRecorder::stop()
+{
+	m_connections.clear();
+	if ( m_stream.is_open() )
+		m_stream.close();
+}
+
+void InputRecorder::record( RecordedInput& input, const TimePoint& time )
+{
+	input.timeMicros = std::chrono::duration_cast<std::chrono::microseconds>( time - m_startTime ).count();
+	writeInput( m_stream, input );
+	++m_numRecorded;
+}
+
+// --- InputPlayer
+
+bool InputPlayer::load( const std::string& path )
+{
+	m_inputs.clear();
+	std::ifstream stream( path, std::ios::binary );
+	if ( !stream.is_open() ) {
+		std::cerr << "InputPlayer::load() - can't open " << path << std::endl;
+		return false;
+	}
+	return readInputLog( stream, m_inputs );
+}
+
+InputPlayer::Report InputPlayer::play( std::shared_ptr<Scene> scene )
+{
+	return play( scene, Options() );
+}
+
+InputPlayer::Report InputPlayer::play( std::shared_ptr<Scene> scene, const Options& options )
+{
+	Report report;
+	if ( !scene || options.frameRate <= 0. )
+		return report;
+
+	auto frameMicros = ( int64_t )( 1e6 / options.frameRate );
+	auto start       = Clock::now();
+	int64_t frameEnd = 0;  // recorded time
+	size_t next      = 0;
+
+	while ( next < m_inputs.size() ) {
+		frameEnd += frameMicros;
+		if ( options.speed > 0. ) {
+			std::this_thread::sleep_until( start + std::chrono::microseconds( ( int64_t )( frameEnd / options.speed ) ) );
+		}
+
+		// events are stamped with the time they're replayed, so latency stats stay meaningful
+		auto frameStart = Clock::now();
+		for ( ; next < m_inputs.size() && m_inputs[next].timeMicros < frameEnd; ++next ) {
+			auto& input = m_inputs[next];
+			switch ( input.device ) {
+				case RecordedInput::Device::KEY: {
+					auto e = input.toKeyEvent();
+					scene->handleKeyEvent( e );
+					break;
+				}
+				case RecordedInput::Device::MOUSE: {
+					auto e = input.toMouseEvent();
+					scene->handleMouseEvent( e );
+					break;
+				}
+				case RecordedInput::Device::TOUCH: {
+					auto e = input.toTouchEvent();
+					scene->handleTouchEvent( e );
+					break;
+				}
+			}
+			++report.events;
+		}
+		scene->update();
+		if ( options.draw )
+			scene->draw();
+		report.frameTime.add( frameStart, Clock::now() );
+		++report.frames;
+	}
+
+	report.durationMs = std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+	return report;
+}
+
+}  // namespace ga
@@ -0,0 +1,106 @@
+#pragma once
+#include "ga/events.h"
+#include "ga/latency.h"
+#include "ga/signal.h"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ga {
+
+class Scene;
+
+// one input event as stored in an input log, timed from the start of the recording
+struct RecordedInput
+{
+	enum class Device : uint8_t
+	{
+		KEY,
+		MOUSE,
+		TOUCH
+	};
+
+	Device device;
+	uint8_t type;        // the event's Type enum
+	int64_t timeMicros;  // since the recording started
+	int32_t code;        // key, mouse button or touch id
+	vec2 position;       // mouse / touch
+	vec2 size;           // touch
+	float angle    = 0.f;
+	float pressure = 0.f;
+
+	KeyEvent toKeyEvent() const;
+	MouseEvent toMouseEvent() const;
+	TouchEvent toTouchEvent() const;
+};
+
+// binary input log: a header, then one record per event (native byte order)
+// records share device, type, time and code, followed by the fields for that device -
+// none for keys, position for mouse, position / size / angle / pressure for touch
+bool writeInputLogHeader( std::ostream& stream );
+void writeInput( std::ostream& stream, const RecordedInput& input );
+bool readInputLog( std::istream& stream, std::vector<RecordedInput>& inputs );
+
+/**
+ * @brief InputRecorder writes every event passed to a Scene's handle*Event() to a binary log,
+ * before any queuing or coalescing.
+ */
+class InputRecorder
+{
+public:
+	~InputRecorder() { stop(); }
+
+	bool start( std::shared_ptr<Scene> scene, const std::string& path );
+	void stop();
+
+	bool isRecording() const { return m_stream.is_open(); }
+	size_t getNumRecorded() const { return m_numRecorded; }
+
+protected:
+	void record( RecordedInput& input, const TimePoint& time );
+
+	std::ofstream m_stream;
+	TimePoint m_startTime;
+	size_t m_numRecorded = 0;
+	std::vector<ScopedConnection> m_connections;
+};
+
+/**
+ * @brief InputPlayer replays an input log into a Scene, at recorded speed or as fast as possible.
+ *
+ * Playback runs its own frame loop - update(), and optionally draw() - so a Scene can be
+ * driven headless, i.e. for load testing the event dispatch and TouchZone paths.
+ */
+class InputPlayer
+{
+public:
+	struct Options
+	{
+		double speed     = 1.;   // playback speed - 0 for as fast as possible
+		double frameRate = 60.;  // frames per second of recorded time
+		bool draw        = false;
+	};
+
+	struct Report
+	{
+		size_t frames     = 0;
+		size_t events     = 0;
+		double durationMs = 0.;  // wall time
+		LatencyHistogram frameTime;  // events + update() + draw(), per frame
+	};
+
+	bool load( const std::string& path );
+	void setInputs( const std::vector<RecordedInput>& inputs ) { m_inputs = inputs; }
+	const std::vector<RecordedInput>& getInputs() const { return m_inputs; }
+
+	// blocks until every input has been dispatched
+	Report play( std::shared_ptr<Scene> scene, const Options& options );
+	Report play( std::shared_ptr<Scene> scene );  // at recorded speed, 60 fps
+
+protected:
+	std::vector<RecordedInput> m_inputs;
+};
+
+}  // namespace ga
@@ -1,4 +1,5 @@
 #include "ga/graph/node.h"
+#include "ga/graph/components/bounds_component.h"
 #include "ga/graph/scene.h"
 #include "ga/render.h"
 
@@ -35,6 +36,8 @@ bool Node::removeChild( std::shared_ptr<Node> child )
 	};
 	m_children.erase( std::remove_if( m_children.begin(), m_children.end(), fn ),
 	                  m_children.end() );
+	if ( removed )
+		flagTreeBoundsDirty();
 	return removed;
 }
 
@@ -56,6 +59,7 @@ void Node::clearChildren()
 		child->setScene( nullptr );
 	}
 	m_children.clear();
+	flagTreeBoundsDirty();
 }
 
 void Node::sortChildren( std::function<bool( const std::shared_ptr<Node>& a, const std::shared_ptr<Node>& b )> comparisonFn )
@@ -111,13 +115,120 @@ size_t Node::getSceneDrawIndex() const
 	return m_drawIndex;
 }
 
+// --- tween targets
+
+Property<vec3> Node::getTranslationProperty()
+{
+	return Property<vec3>(
+	    shared_from_this(), static_cast<Transform*>( this ),
+	    []( void* target, const vec3& value ) { static_cast<Transform*>( target )->setTranslation( value ); },
+	    []( const void* target ) { return static_cast<const Transform*>( target )->getTranslation(); } );
+}
+
+Property<quat> Node::getRotationProperty()
+{
+	return Property<quat>(
+	    shared_from_this(), static_cast<Transform*>( this ),
+	    []( void* target, const quat& value ) { static_cast<Transform*>( target )->setRotation( value ); },
+	    []( const void* target ) { return static_cast<const Transform*>( target )->getRotation(); } );
+}
+
+Property<vec3> Node::getScaleProperty()
+{
+	return Property<vec3>(
+	    shared_from_this(), static_cast<Transform*>( this ),
+	    []( void* target, const vec3& value ) { static_cast<Transform*>( target )->setScale( value ); },
+	    []( const void* target ) { return static_cast<const Transform*>( target )->getScale(); } );
+}
+
 ga::Transform Node::getSceneTransform()
 {
-	if ( auto parent = m_parent.lock() ) {
-		return parent->getSceneTransform() * getTransform();  //getLocalTransform();
-	} else {
-		return getTransform();  //getLocalTransform();
+	return ga::Transform( getSceneMatrix() );
+}
+
+const mat4& Node::getSceneMatrix()
+{
+	if ( m_isSceneMatrixDirty ) {
+		if ( auto parent = m_parent.lock() ) {
+			m_sceneMatrix = parent->getSceneMatrix() * getMatrix();
+		} else {
+			m_sceneMatrix = getMatrix();
+		}
+		++m_sceneMatrixVersion;
+		m_isSceneMatrixDirty = false;
+	}
+	return m_sceneMatrix;
+}
+
+const mat4& Node::getInverseSceneMatrix()
+{
+	if ( m_isInverseSceneMatrixDirty ) {
+		m_inverseSceneMatrix        = glm::inverse( getSceneMatrix() );
+		m_isInverseSceneMatrixDirty = false;
+	}
+	return m_inverseSceneMatrix;
+}
+
+void Node::localPointsToScene( const std::vector<vec3>& in, std::vector<vec3>& out )
+{
+	out.resize( in.size() );
+	localPointsToScene( in.data(), out.data(), in.size() );
+}
+
+void Node::scenePointsToLocal( const std::vector<vec3>& in, std::vector<vec3>& out )
+{
+	out.resize( in.size() );
+	scenePointsToLocal( in.data(), out.data(), in.size() );
+}
+
+Bounds3D Node::getSceneBounds()
+{
+	auto it = m_components.find( std::type_index( typeid( Bounds ) ) );
+	if ( it == m_components.end() || !it->second )
+		return Bounds3D::empty();
+	auto& bounds = static_cast<Bounds&>( *it->second );
+	return Bounds3D { bounds.min, bounds.max }.transformed( getSceneMatrix() );
+}
+
+bool Node::intersectRay( const Ray& sceneRay, float& t, vec3& localPos )
+{
+	auto it = m_components.find( std::type_index( typeid( Bounds ) ) );
+	if ( it == m_components.end() || !it->second )
+		return false;
+	auto& bounds  = static_cast<Bounds&>( *it->second );
+	auto localRay = sceneRay.transformed( getInverseSceneMatrix() );
+	if ( !localRay.intersects( Bounds3D { bounds.min, bounds.max }, t ) )
+		return false;
+	localPos = localRay.at( t );
+	return true;
+}
+
+const Bounds3D& Node::getTreeBounds()
+{
+	if ( m_isTreeBoundsDirty ) {
+		m_treeBounds = Bounds3D::empty();
+		auto it      = m_components.find( std::type_index( typeid( Bounds ) ) );
+		if ( it != m_components.end() && it->second ) {
+			auto& bounds = static_cast<Bounds&>( *it->second );
+			m_treeBounds.include( Bounds3D { bounds.min, bounds.max } );
+		}
+		for ( auto& child : m_children ) {
+			auto& childBounds = child->getTreeBounds();
+			if ( !childBounds.isEmpty() )
+				m_treeBounds.include( childBounds.transformed( child->getMatrix() ) );
+		}
+		m_isTreeBoundsDirty = false;
 	}
+	return m_treeBounds;
+}
+
+void Node::flagTreeBoundsDirty()
+{
+	if ( m_isTreeBoundsDirty )
+		return;  // ancestors are already dirty
+	m_isTreeBoundsDirty = true;
+	if ( auto parent = m_parent.lock() )
+		parent->flagTreeBoundsDirty();
 }
 
 void Node::disableDraw()
@@ -140,6 +251,24 @@ void Node::enableUpdate()
 	m_isUpdateEnabled = true;
 }
 
+void Node::setUpdateRate( double hz )
+{
+	auto interval = hz > 0. ? std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( 1. / hz ) ) : Clock::duration::zero();
+	if ( interval == m_updateInterval )
+		return;
+	auto scene = m_scene.lock();
+	if ( scene && m_updateInterval != Clock::duration::zero() )
+		scene->unscheduleUpdate( this );
+	m_updateInterval = interval;
+	if ( scene && m_updateInterval != Clock::duration::zero() )
+		scene->scheduleUpdate( this );
+}
+
+double Node::getUpdateRate() const
+{
+	return m_updateInterval != Clock::duration::zero() ? 1. / std::chrono::duration<double>( m_updateInterval ).count() : 0.;
+}
+
 std::shared_ptr<Node> Node::getParent() const
 {
 	return m_parent.lock();
@@ -163,6 +292,9 @@ Node::Node()
 void Node::setParent( std::shared_ptr<Node> parent )
 {
 	m_parent = parent;
+	flagSceneMatrixDirty();
+	if ( parent )
+		parent->flagTreeBoundsDirty();
 }
 
 // virtual methods
@@ -190,11 +322,73 @@ void Node::setDrawIndex( size_t index )
 	}
 }
 
-void Node::updateTree()
+void Node::onTransformChange()
+{
+	flagSceneMatrixDirty();
+	if ( auto parent = m_parent.lock() )
+		parent->flagTreeBoundsDirty();  // tree bounds are in local space, so only ancestors change
+
+	if ( !m_isFixedUpdate )
+		return;  // nothing to interpolate
+
+	// on the first change in a fixed update step, keep the state from the step before
+	auto scene = m_scene.lock();
+	if ( scene && m_stateStep != scene->getUpdateStep() ) {
+		m_prevState = m_currState;
+		m_stateStep = scene->getUpdateStep();
+	}
+	m_currState = { m_translation, m_rotation, m_scale };
+}
+
+mat4 Node::getDrawMatrix( const Scene& scene ) const
+{
+	// only nodes that moved in the last step need interpolating
+	float alpha = scene.getInterpolationAlpha();
+	if ( !scene.isFixedUpdateEnabled() || m_stateStep != scene.getUpdateStep() || alpha >= 1.f )
+		return getMatrix();
+	auto matrix = glm::translate( mat4( 1.0 ), glm::mix( m_prevState.translation, m_currState.translation, alpha ) );
+	matrix      = matrix * glm::toMat4( glm::slerp( m_prevState.rotation, m_currState.rotation, alpha ) );
+	return glm::scale( matrix, glm::mix( m_prevState.scale, m_currState.scale, alpha ) );
+}
+
+void Node::flagSceneMatrixDirty()
+{
+	if ( m_isSceneMatrixDirty )
+		return;  // descendants are already dirty, and the scene already told
+	m_isSceneMatrixDirty        = true;
+	m_isInverseSceneMatrixDirty = true;
+	flagSceneIndexDirty();
+	for ( auto& child : m_children ) {
+		child->flagSceneMatrixDirty();
+	}
+}
+
+void Node::flagSceneIndexDirty()
+{
+	if ( m_touchZoneCount == 0 && !m_pickBounds )
+		return;  // not indexed - skip the scene lookup
+	if ( auto scene = m_scene.lock() )
+		scene->flagNodeIndexDirty( *this );
+}
+
+void Node::updateTree( UpdateStats& stats )
 {
 	if ( !m_isUpdateEnabled )
 		return;
+	if ( m_isSleeping ) {
+		++stats.sleeping;
+		return;
+	}
+	if ( m_updateInterval != Clock::duration::zero() ) {
+		++stats.throttled;
+		return;
+	}
+	updateSubtree( stats );
+}
 
+void Node::updateSubtree( UpdateStats& stats )
+{
+	++stats.updated;
 	onWillUpdate();
 
 	// update components
@@ -209,16 +403,26 @@ void Node::updateTree()
 	onWillUpdateChildren();
 
 	for ( auto& child : m_children ) {
-		child->updateTree();
+		child->updateTree( stats );
 	}
 
 	onDidUpdateChildren();
 	onDidUpdate();
 }
 
+bool Node::isUpdateReachable() const
+{
+	for ( auto node = this; node; node = node->m_parent.lock().get() ) {
+		if ( !node->m_isUpdateEnabled || node->m_isSleeping )
+			return false;
+	}
+	return true;
+}
+
 void Node::drawTree()
 {
-	if ( auto scene = m_scene.lock() ) {
+	auto scene = m_scene.lock();
+	if ( scene ) {
 		// store draw index for later comparison, etc.
 		setDrawIndex( scene->nextDrawIndex( shared_from_this() ) );
 	}
@@ -226,9 +430,13 @@ void Node::drawTree()
 	if ( !m_isDrawEnabled )
 		return;
 
+	// skip this node and its children if they are out of view
+	if ( scene && scene->isCulled( *this ) )
+		return;
+
 	// transform to local space
 	getRenderer().pushMatrix();
-	getRenderer().multMatrix( Transform::getMatrix() );
+	getRenderer().multMatrix( scene ? getDrawMatrix( *scene ) : Transform::getMatrix() );
 
 	onWillDraw();
 
@@ -262,9 +470,30 @@ void Node::walkTree( std::function<void( std::shared_ptr<Node> )> fn )
 	}
 }
 
+void Node::setFixedUpdate( bool isEnabled )
+{
+	if ( isEnabled && !m_isFixedUpdate ) {
+		// moves weren't tracked while disabled - start from the current transform
+		m_currState = m_prevState = { m_translation, m_rotation, m_scale };
+		m_stateStep = 0;
+	}
+	m_isFixedUpdate = isEnabled;
+}
+
 void Node::setScene( std::shared_ptr<Scene> scene )
 {
+	// move throttled nodes to the new scene's schedule
+	if ( m_updateInterval != Clock::duration::zero() ) {
+		auto oldScene = m_scene.lock();
+		if ( oldScene != scene ) {
+			if ( oldScene )
+				oldScene->unscheduleUpdate( this );
+			if ( scene )
+				scene->scheduleUpdate( this );
+		}
+	}
 	m_scene = scene;
+	setFixedUpdate( scene && scene->isFixedUpdateEnabled() );
 	// notify components
 	for ( auto& c : m_components ) {
 		if ( c.second )
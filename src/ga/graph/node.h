@@ -12,9 +12,11 @@
 #pragma once
 #include "ga/defines.h"
 #include "ga/graph/component.h"
+#include "ga/property.h"
 #include "ga/transform.h"
 #include "ga/uuid.h"
 #include "ga/signal.h"
+#include "ga/timer.h"
 #include <algorithm>
 #include <functional>
 #include <memory>
@@ -28,6 +30,7 @@
 namespace ga {
 
 class Scene;
+class Bounds;
 
 /**
  * @brief Node represents a basic "node" (or view) in the scenegraph.
@@ -98,6 +101,11 @@ public:
 
 	ga::Transform& getTransform() { return *this; }
 
+	// transform channels as tween targets - writes are skipped once the node is destroyed
+	Property<vec3> getTranslationProperty();
+	Property<quat> getRotationProperty();
+	Property<vec3> getScaleProperty();
+
 	// custom draw / update functions
 
 	void setDrawFn( std::function<void()> drawFn ) { m_drawFn = drawFn; }
@@ -117,10 +125,44 @@ public:
 	// the global / scene space transformation of this node
 	ga::Transform getSceneTransform();
 
+	// the global / scene space matrix of this node
+	// cached - only rebuilt after this node or one of its ancestors is transformed
+	const mat4& getSceneMatrix();
+
+	// inverse of getSceneMatrix(), cached the same way
+	const mat4& getInverseSceneMatrix();
+
 	// helper to convert a local position to scene space
-	vec3 localPosToScene( const vec3& pos ) { return getSceneTransform().getMatrix() * vec4( pos, 1. ); }
+	vec3 localPosToScene( const vec3& pos ) { return getSceneMatrix() * vec4( pos, 1. ); }
 	// helper to convert a scene position to local space
-	vec3 scenePosToLocal( const vec3& pos ) { return glm::inverse( getSceneTransform().getMatrix() ) * vec4( pos, 1. ); }
+	vec3 scenePosToLocal( const vec3& pos ) { return getInverseSceneMatrix() * vec4( pos, 1. ); }
+
+	// batch versions of the helpers above - 'in' and 'out' may be the same array
+	void localPointsToScene( const vec3* in, vec3* out, size_t count ) { ga::transformPoints( getSceneMatrix(), in, out, count ); }
+	void scenePointsToLocal( const vec3* in, vec3* out, size_t count ) { ga::transformPoints( getInverseSceneMatrix(), in, out, count ); }
+	void localPointsToScene( const std::vector<vec3>& in, std::vector<vec3>& out );
+	void scenePointsToLocal( const std::vector<vec3>& in, std::vector<vec3>& out );
+
+	// scene space bounds
+
+	// this node's Bounds component as a scene space box (empty if there is no Bounds component)
+	Bounds3D getSceneBounds();
+
+	// union of this node's and all descendants' Bounds, in local space - descendants without Bounds add nothing,
+	// even if they draw (see Scene::setCullingEnabled)
+	// cached - only rebuilt after a Bounds component or a descendant's transform changes
+	const Bounds3D& getTreeBounds();
+
+	// getTreeBounds() as a scene space box
+	Bounds3D getSceneTreeBounds() { return getTreeBounds().transformed( getSceneMatrix() ); }
+
+	// intersect a scene space ray with this node's Bounds component, as an oriented box
+	// returns the distance along the ray in 't' and the local hit position in 'localPos'
+	bool intersectRay( const Ray& sceneRay, float& t, vec3& localPos );
+
+	// invalidate cached tree bounds for this node and its ancestors
+	// (called automatically by Bounds helpers, call manually after setting Bounds::min / max directly)
+	void flagTreeBoundsDirty();
 
 	// enable / disable node
 
@@ -129,6 +171,25 @@ public:
 
 	bool isUpdateEnabled() const { return m_isUpdateEnabled; }
 
+	// update this Node (and its children) at most 'hz' times per second, i.e. for clocks / tickers.
+	// throttled nodes are scheduled by the scene, so frames they aren't due in don't visit them.
+	// hz <= 0 updates every frame again.
+	void setUpdateRate( double hz );
+	double getUpdateRate() const;
+
+	// a sleeping Node (and its children) isn't updated until wake() - i.e. until an event arrives
+	void sleep() { m_isSleeping = true; }
+	void wake() { m_isSleeping = false; }
+	bool isSleeping() const { return m_isSleeping; }
+
+	// counts from one scene update (see Scene::getUpdateStats)
+	struct UpdateStats
+	{
+		size_t updated   = 0;  // nodes updated
+		size_t throttled = 0;  // throttled subtrees skipped, not due yet
+		size_t sleeping  = 0;  // sleeping subtrees skipped
+	};
+
 	void disableDraw();  // scene WON'T draw() this Node (or its children)
 	void enableDraw();   // scene WILL draw() this Node (and its children)
 
@@ -177,13 +238,25 @@ protected:
 	virtual void onDrawIndexChange();
 	void setDrawIndex( size_t index );
 
+	// invalidates cached scene matrices and parent tree bounds
+	void onTransformChange() override;
+	void flagSceneMatrixDirty();  // flags this node and all descendants (and their inverse matrices)
+	void flagSceneIndexDirty();   // tells the scene's touch / pick indexes this node moved, or its Bounds changed
+
+	// local matrix to draw with - interpolated between fixed update steps (see Scene::setFixedUpdateRate)
+	mat4 getDrawMatrix( const Scene& scene ) const;
+
 	friend class Scene;
+	friend class Bounds;
 
 	void setScene( std::shared_ptr<Scene> scene );
+	void setFixedUpdate( bool isEnabled );  // see m_isFixedUpdate
 	void setParent( std::shared_ptr<Node> parent );
 
 	// update and draw hierarchy
-	void updateTree();
+	void updateTree( UpdateStats& stats );     // skips throttled nodes - the scene updates those when due
+	void updateSubtree( UpdateStats& stats );  // update this node now, then its children
+	bool isUpdateReachable() const;            // true if this node and its ancestors are enabled and awake
 	void drawTree();
 
 	void walkTree( std::function<void( std::shared_ptr<Node> )> fn );  // run arbitrary function on self and children
@@ -201,11 +274,36 @@ protected:
 	size_t m_drawIndex;
 	std::function<void()> m_updateFn;
 	std::function<void()> m_drawFn;
+
+	// cached scene space properties
+	mat4 m_sceneMatrix;
+	mat4 m_inverseSceneMatrix;
+	uint32_t m_sceneMatrixVersion = 0;  // incremented every time m_sceneMatrix is rebuilt
+	Bounds3D m_treeBounds;
+	bool m_isSceneMatrixDirty        = true;
+	bool m_isInverseSceneMatrixDirty = true;
+	bool m_isTreeBoundsDirty         = true;
+	int m_touchZoneCount             = 0;        // zones on this node in the scene's touch index
+	Bounds* m_pickBounds             = nullptr;  // in the scene's pick index
+
+	// transform before and after the last fixed update step that changed it
+	struct TransformState
+	{
+		vec3 translation { 0.f };
+		quat rotation;
+		vec3 scale { 1.f };
+	};
+	TransformState m_prevState, m_currState;
+	uint32_t m_stateStep = 0;
+	bool m_isFixedUpdate = false;  // scene has fixed update enabled - kept in sync by the scene, so moves skip the lookup
+
 	// std::shared_ptr<Mesh> m_mesh;
 	// std::shared_ptr<Matrial> m_material;
 
 	bool m_isDrawEnabled   = true;
 	bool m_isUpdateEnabled = true;
+	bool m_isSleeping      = false;
+	Clock::duration m_updateInterval = Clock::duration::zero();  // throttled when non-zero
 };
 
 // template implementations
@@ -270,6 +368,8 @@ std::shared_ptr<ComponentT> Node::addComponent( std::shared_ptr<ComponentT> comp
 	auto r = m_components.insert( p );  // returns <it, bool>
 	if ( r.second ) {
 		componentPtr->setNode( shared_from_this() );
+		static_cast<Component&>( *componentPtr ).setScene( m_scene.lock() );
+		flagTreeBoundsDirty();  // in case it's a Bounds component
 	}
 	return r.second ? componentPtr : nullptr;
 }
@@ -316,10 +416,11 @@ bool Node::removeComponent()
 {
 	auto it = m_components.find( typeid( ComponentT ) );
 	if ( it != m_components.end() ) {
-		//if (it->second) {
-		//    it->second->m_components = nullptr;
-		//}
+		if ( it->second ) {
+			it->second->setScene( nullptr );
+		}
 		m_components.erase( it );
+		flagTreeBoundsDirty();
 		return true;
 	} else {
 		return false;
@@ -1,7 +1,16 @@
 #include "ga/graph/scene.h"
+#include "ga/graph/components/bounds_component.h"
+#include "ga/graph/components/touchzone_component.h"
+#include "ga/coroutine.h"
+#include "ga/render.h"
+#include "ga/spring.h"
+#include "ga/tween_engine.h"
+#include <algorithm>
 
 namespace ga {
 
+constexpr int SpatialGrid::s_maxCells;
+
 Scene::Scene()
     : m_rootNode( Node::create() )
 {
@@ -20,13 +29,37 @@ void Scene::setup()
 
 void Scene::update()
 {
-	m_timeoutManager.updateTimeouts();
-	updateNodes();
+	if ( m_clock )
+		m_clock->advance();  // one 'now' for every timer this frame
+
+	if ( !isFixedUpdateEnabled() || !m_clock ) {
+		updateStep();
+		return;
+	}
+
+	// catch up to the clock in fixed steps, dropping what's too far behind to catch up on
+	auto now = m_clock->now();
+	if ( m_fixedStepTime == TimePoint() ) {
+		m_fixedStepTime = now - m_fixedStep;  // first frame
+	} else if ( now - m_fixedStepTime > m_fixedStep * m_maxFixedSteps ) {
+		m_fixedStepTime = now - m_fixedStep * m_maxFixedSteps;
+	}
+	while ( m_fixedStepTime + m_fixedStep <= now ) {
+		m_fixedStepTime += m_fixedStep;
+		m_clock->hold( m_fixedStepTime );
+		updateStep();
+	}
+	m_clock->release();
+	m_interpolationAlpha = ( float )( ( now - m_fixedStepTime ).count() ) / m_fixedStep.count();
 }
 
 void Scene::draw()
 {
 	drawNodes();
+	if ( m_isLatencyTrackingEnabled ) {
+		m_latencyDrawn.clear();  // not presented, if the app doesn't call markFramePresented()
+		trackLatency( m_latencyUpdated, &m_latencyDrawn, m_latencyStats.draw );
+	}
 }
 
 std::shared_ptr<ga::Node> Scene::addNode()
@@ -76,35 +109,348 @@ const std::string& Scene::getName()
 	return m_name;
 }
 
+void Scene::setClock( FrameClock* clock )
+{
+	m_clock = clock;
+	m_timeoutManager.setClock( clock );
+}
+
+void Scene::setFixedUpdateRate( double hz, int maxStepsPerFrame )
+{
+	m_fixedStep          = hz > 0. ? std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( 1. / hz ) ) : Clock::duration::zero();
+	m_maxFixedSteps      = std::max( maxStepsPerFrame, 1 );
+	m_fixedStepTime      = TimePoint();
+	m_interpolationAlpha = 1.f;
+	bool isEnabled       = isFixedUpdateEnabled();
+	forEachNode( [isEnabled]( std::shared_ptr<Node> node ) { node->setFixedUpdate( isEnabled ); } );
+}
+
+double Scene::getFixedUpdateRate() const
+{
+	return isFixedUpdateEnabled() ? 1. / std::chrono::duration<double>( m_fixedStep ).count() : 0.;
+}
+
+void Scene::setCullViewport( const Rect& viewport )
+{
+	m_cullViewport    = viewport;
+	m_hasCullViewport = true;
+}
+
+void Scene::clearCullViewport()
+{
+	m_hasCullViewport = false;
+}
+
+std::vector<Scene::PickHit> Scene::pick( const vec2& windowPos )
+{
+	auto& renderer = getRenderer();
+	if ( renderer.getViewport().area() == 0.f )
+		return {};
+	return pick( renderer.windowPosToRay( windowPos ) );
+}
+
+std::vector<Scene::PickHit> Scene::pick( const Ray& sceneRay )
+{
+	updatePickIndex();
+
+	std::vector<PickHit> hits;
+	m_pickBvh.raycast( sceneRay, [&]( uint32_t item, float ) {
+		// scene space box was hit, now test the node's oriented box
+		auto node = m_pickables[item]->getNode();
+		PickHit hit;
+		if ( node && node->intersectRay( sceneRay, hit.distance, hit.localPosition ) ) {
+			hit.node          = node;
+			hit.scenePosition = sceneRay.at( hit.distance );
+			hits.push_back( hit );
+		}
+	} );
+	std::sort( hits.begin(), hits.end(), []( const PickHit& a, const PickHit& b ) { return a.distance < b.distance; } );
+	return hits;
+}
+
 void Scene::handleMouseEvent( MouseEvent& mouseEvent )
+{
+	++m_frameInputStats.received;
+	onMouseInput( mouseEvent );
+	if ( !m_isInputQueueEnabled ) {
+		dispatchMouseEvent( mouseEvent );
+		return;
+	}
+
+	// coalesce into the last queued mouse event if it's the same kind of move
+	bool isMove = mouseEvent.type == MouseEvent::Type::MOVE || mouseEvent.type == MouseEvent::Type::DRAG;
+	for ( auto it = m_inputQueue.rbegin(); isMove && it != m_inputQueue.rend(); ++it ) {
+		if ( it->type == QueuedInput::Type::TOUCH )
+			continue;
+		if ( it->type == QueuedInput::Type::MOUSE ) {
+			auto& queued = m_queuedMouseEvents[it->index];
+			if ( queued.type == mouseEvent.type && queued.button == mouseEvent.button ) {
+				auto history = std::move( queued.history );
+				history.push_back( queued.position );
+				queued         = mouseEvent;
+				queued.history = std::move( history );
+				++m_frameInputStats.coalesced;
+				return;
+			}
+		}
+		break;
+	}
+	m_inputQueue.push_back( { QueuedInput::Type::MOUSE, m_queuedMouseEvents.size(), mouseEvent.time } );
+	m_queuedMouseEvents.push_back( mouseEvent );
+}
+
+void Scene::handleTouchEvent( TouchEvent& touchEvent )
+{
+	++m_frameInputStats.received;
+	onTouchInput( touchEvent );
+	if ( !m_isInputQueueEnabled ) {
+		dispatchTouchEvent( touchEvent );
+		return;
+	}
+
+	// coalesce into the last queued event for this touch, if it's also a drag
+	for ( auto it = m_inputQueue.rbegin(); touchEvent.type == TouchEvent::Type::DRAG && it != m_inputQueue.rend(); ++it ) {
+		if ( it->type == QueuedInput::Type::MOUSE )
+			continue;
+		if ( it->type == QueuedInput::Type::TOUCH ) {
+			auto& queued = m_queuedTouchEvents[it->index];
+			if ( queued.id != touchEvent.id )
+				continue;
+			if ( queued.type == TouchEvent::Type::DRAG ) {
+				auto history = std::move( queued.history );
+				history.push_back( queued.position );
+				queued         = touchEvent;
+				queued.history = std::move( history );
+				++m_frameInputStats.coalesced;
+				return;
+			}
+		}
+		break;
+	}
+	m_inputQueue.push_back( { QueuedInput::Type::TOUCH, m_queuedTouchEvents.size(), touchEvent.time } );
+	m_queuedTouchEvents.push_back( touchEvent );
+}
+
+void Scene::findTouchZones( const vec2& position, std::vector<TouchZone*>& zones )
+{
+	size_t first = zones.size();
+	collectTouchZones( position, zones );
+	sortByDrawOrder( zones, first );
+}
+
+void Scene::handleKeyEvent( KeyEvent& keyEvent )
+{
+	++m_frameInputStats.received;
+	onKeyInput( keyEvent );
+	if ( !m_isInputQueueEnabled ) {
+		dispatchKeyEvent( keyEvent );
+		return;
+	}
+	m_inputQueue.push_back( { QueuedInput::Type::KEY, m_queuedKeyEvents.size(), keyEvent.time } );
+	m_queuedKeyEvents.push_back( keyEvent );
+}
+
+void Scene::setInputQueueEnabled( bool enabled )
+{
+	if ( m_isInputQueueEnabled && !enabled ) {
+		processInputQueue();  // don't drop buffered events
+	}
+	m_isInputQueueEnabled = enabled;
+}
+
+void Scene::setLatencyTrackingEnabled( bool enabled )
+{
+	m_isLatencyTrackingEnabled = enabled;
+	m_latencyDispatched.clear();
+	m_latencyUpdated.clear();
+	m_latencyDrawn.clear();
+}
+
+void Scene::markFramePresented()
+{
+	if ( m_isLatencyTrackingEnabled )
+		trackLatency( m_latencyDrawn, nullptr, m_latencyStats.present );
+}
+
+void Scene::resetLatencyStats()
+{
+	m_latencyStats.dispatch.clear();
+	m_latencyStats.update.clear();
+	m_latencyStats.draw.clear();
+	m_latencyStats.present.clear();
+}
+
+void Scene::processInputQueue()
+{
+	// swap buffers, so handlers can queue new events for the next frame
+	std::swap( m_inputQueue, m_processingInputQueue );
+	std::swap( m_queuedKeyEvents, m_processingKeyEvents );
+	std::swap( m_queuedMouseEvents, m_processingMouseEvents );
+	std::swap( m_queuedTouchEvents, m_processingTouchEvents );
+
+	for ( auto& queued : m_processingInputQueue ) {
+		switch ( queued.type ) {
+			case QueuedInput::Type::KEY:
+				dispatchKeyEvent( m_processingKeyEvents[queued.index] );
+				break;
+			case QueuedInput::Type::MOUSE:
+				dispatchMouseEvent( m_processingMouseEvents[queued.index] );
+				break;
+			case QueuedInput::Type::TOUCH:
+				dispatchTouchEvent( m_processingTouchEvents[queued.index] );
+				break;
+		}
+		// latency from the oldest coalesced event
+		recordDispatch( queued.firstTime );
+	}
+
+	m_processingInputQueue.clear();
+	m_processingKeyEvents.clear();
+	m_processingMouseEvents.clear();
+	m_processingTouchEvents.clear();
+
+	// publish stats for this frame
+	if ( m_frameInputStats.dispatched ) {
+		m_frameInputStats.avgLatencyMs = m_frameLatencySumMs / m_frameInputStats.dispatched;
+	}
+	m_inputStats        = m_frameInputStats;
+	m_frameInputStats   = InputStats();
+	m_frameLatencySumMs = 0.;
+}
+
+void Scene::dispatchMouseEvent( MouseEvent& mouseEvent )
 {
 	// trigger signal
 	onMouseEvent( mouseEvent );
+	if ( !m_isInputQueueEnabled )
+		recordDispatch( mouseEvent.time );
 }
 
-void Scene::handleTouchEvent( TouchEvent& touchEvent )
+void Scene::dispatchTouchEvent( TouchEvent& touchEvent )
 {
 	// trigger signal
 	onTouchEvent( touchEvent );
+	// then touch zones, top-most first
+	dispatchTouchZones( touchEvent );
+	if ( !m_isInputQueueEnabled )
+		recordDispatch( touchEvent.time );
 }
 
-void Scene::handleKeyEvent( KeyEvent& keyEvent )
+void Scene::dispatchKeyEvent( KeyEvent& keyEvent )
 {
 	// trigger signal
 	onKeyEvent( keyEvent );
+	if ( !m_isInputQueueEnabled )
+		recordDispatch( keyEvent.time );
+}
+
+void Scene::recordDispatch( const TimePoint& eventTime )
+{
+	double latencyMs = std::chrono::duration<double, std::milli>( Clock::now() - eventTime ).count();
+	++m_frameInputStats.dispatched;
+	m_frameLatencySumMs += latencyMs;
+	m_frameInputStats.maxLatencyMs = std::max( m_frameInputStats.maxLatencyMs, latencyMs );
+	if ( m_isLatencyTrackingEnabled ) {
+		m_latencyStats.dispatch.add( latencyMs );
+		m_latencyDispatched.push_back( eventTime );
+	}
+}
+
+// record the latency of every event waiting in 'from', then move them on to the next stage
+void Scene::trackLatency( std::vector<TimePoint>& from, std::vector<TimePoint>* to, LatencyHistogram& histogram )
+{
+	if ( from.empty() )
+		return;
+	auto now = Clock::now();
+	for ( auto& eventTime : from ) {
+		histogram.add( eventTime, now );
+	}
+	if ( to )
+		to->insert( to->end(), from.begin(), from.end() );
+	from.clear();
 }
 
 // --- protected - internal
 
+void Scene::updateStep()
+{
+	++m_updateStep;
+	processInputQueue();
+	m_timeoutManager.updateTimeouts();
+	getTweenEngine().update();
+	getSpringEngine().update();
+	updateNodes();
+#ifdef GA_HAS_COROUTINES
+	getCoroutineScheduler().update();
+#endif
+	if ( m_isLatencyTrackingEnabled )
+		trackLatency( m_latencyDispatched, &m_latencyUpdated, m_latencyStats.update );
+}
+
 void Scene::updateNodes()
 {
+	m_updateStats = Node::UpdateStats();
 	if ( m_rootNode )
-		m_rootNode->updateTree();
+		m_rootNode->updateTree( m_updateStats );
+	updateScheduledNodes();
+}
+
+void Scene::scheduleUpdate( Node* node )
+{
+	auto it = std::find_if( m_updateBuckets.begin(), m_updateBuckets.end(),
+	                        [node]( const UpdateBucket& b ) { return b.interval == node->m_updateInterval; } );
+	if ( it == m_updateBuckets.end() ) {
+		m_updateBuckets.push_back( { node->m_updateInterval, TimePoint(), {} } );
+		it = m_updateBuckets.end() - 1;
+	}
+	it->nodes.push_back( node );
+}
+
+void Scene::unscheduleUpdate( Node* node )
+{
+	for ( auto& bucket : m_updateBuckets ) {
+		bucket.nodes.erase( std::remove( bucket.nodes.begin(), bucket.nodes.end(), node ), bucket.nodes.end() );
+	}
+	std::replace( m_dueNodes.begin(), m_dueNodes.end(), node, ( Node* )nullptr );
+	m_updateBuckets.erase( std::remove_if( m_updateBuckets.begin(), m_updateBuckets.end(), []( const UpdateBucket& b ) { return b.nodes.empty(); } ),
+	                       m_updateBuckets.end() );
+}
+
+void Scene::updateScheduledNodes()
+{
+	auto now = m_clock ? m_clock->now() : Clock::now();
+	m_dueNodes.clear();
+	for ( auto& bucket : m_updateBuckets ) {
+		if ( now < bucket.nextTime )
+			continue;
+		// keep the cadence, unless a whole interval was missed
+		bucket.nextTime += bucket.interval;
+		if ( bucket.nextTime <= now )
+			bucket.nextTime = now + bucket.interval;
+		m_dueNodes.insert( m_dueNodes.end(), bucket.nodes.begin(), bucket.nodes.end() );
+	}
+	// nodes may be (un)scheduled from update callbacks
+	for ( size_t i = 0; i < m_dueNodes.size(); ++i ) {
+		auto node = m_dueNodes[i];
+		if ( node && node->isUpdateReachable() )
+			node->updateSubtree( m_updateStats );
+	}
+	m_dueNodes.clear();
 }
 
 void Scene::drawNodes()
 {
 	m_drawnNodes.clear();
+	m_cullStats = CullStats();
+	if ( m_isCullingEnabled ) {
+		if ( m_hasCullViewport ) {
+			m_cullFrustum = Frustum::fromRect( m_cullViewport );
+		} else {
+			auto& r       = getRenderer();
+			auto mvp      = r.getMatrix( MatrixType::PROJECTION ) * r.getMatrix( MatrixType::VIEW ) * r.getMatrix( MatrixType::MODEL );
+			m_cullFrustum = Frustum::fromMatrix( mvp );
+		}
+	}
 	if ( m_rootNode )
 		m_rootNode->drawTree();
 }
@@ -117,6 +463,221 @@ size_t Scene::nextDrawIndex( std::shared_ptr<Node> node )
 	return m_drawnNodes.size() - 1;
 }
 
+bool Scene::isCulled( Node& node )
+{
+	if ( !m_isCullingEnabled )
+		return false;
+	auto bounds = node.getSceneTreeBounds();
+	if ( bounds.isEmpty() )
+		return false;  // nothing to test against
+	++m_cullStats.tested;
+	if ( m_cullFrustum.intersects( bounds ) )
+		return false;
+	++m_cullStats.culled;
+	return true;
+}
+
+void Scene::addTouchZone( TouchZone* zone )
+{
+	if ( zone && std::find( m_touchZones.begin(), m_touchZones.end(), zone ) == m_touchZones.end() ) {
+		m_touchZones.push_back( zone );
+		if ( auto node = zone->getNode() )
+			++node->m_touchZoneCount;  // so it flags the index when it moves
+		if ( zone->getState() == TouchZone::State::ACTIVE )
+			setTouchZoneActive( zone, true );
+		m_isTouchIndexDirty = true;
+	}
+}
+
+void Scene::removeTouchZone( TouchZone* zone )
+{
+	auto it = std::find( m_touchZones.begin(), m_touchZones.end(), zone );
+	if ( it != m_touchZones.end() ) {
+		m_touchZones.erase( it );
+		if ( auto node = zone->getNode() )
+			--node->m_touchZoneCount;
+	}
+	setTouchZoneActive( zone, false );
+	for ( auto it = m_touchOwners.begin(); it != m_touchOwners.end(); ) {
+		it = it->second == zone ? m_touchOwners.erase( it ) : std::next( it );
+	}
+	// zone may be removed mid-dispatch (i.e. from a callback)
+	std::replace( m_touchCandidates.begin(), m_touchCandidates.end(), zone, ( TouchZone* )nullptr );
+	m_isTouchIndexDirty = true;
+}
+
+void Scene::setTouchZoneActive( TouchZone* zone, bool isActive )
+{
+	auto it = std::find( m_activeTouchZones.begin(), m_activeTouchZones.end(), zone );
+	if ( isActive && it == m_activeTouchZones.end() ) {
+		m_activeTouchZones.push_back( zone );
+	} else if ( !isActive && it != m_activeTouchZones.end() ) {
+		m_activeTouchZones.erase( it );
+	}
+}
+
+void Scene::setTouchOwner( int pointerId, TouchZone* zone )
+{
+	m_touchOwners[pointerId] = zone;
+}
+
+void Scene::clearTouchOwner( int pointerId, TouchZone* zone )
+{
+	auto it = m_touchOwners.find( pointerId );
+	if ( it != m_touchOwners.end() && it->second == zone )
+		m_touchOwners.erase( it );
+}
+
+void Scene::rebuildTouchIndex()
+{
+	m_indexedTouchZones.clear();
+	m_unindexedTouchZones.clear();
+	m_touchZoneBounds.clear();
+	for ( auto zone : m_touchZones ) {
+		auto node = zone->getNode();
+		if ( !node )
+			continue;
+		auto bounds = node->getSceneBounds();
+		if ( bounds.isEmpty() || zone->getAreBoundsInverted() || zone->getIsUsingCustomBoundsTest() || zone->getIsUsingRayCast() ) {
+			m_unindexedTouchZones.push_back( zone );
+		} else {
+			m_indexedTouchZones.push_back( zone );
+			m_touchZoneBounds.push_back( bounds );
+		}
+	}
+	m_touchGrid.build( m_touchZoneBounds );
+	m_isTouchIndexDirty = false;
+}
+
+void Scene::collectTouchZones( const vec2& position, std::vector<TouchZone*>& zones )
+{
+	if ( m_isTouchIndexDirty )
+		rebuildTouchIndex();
+	m_touchQuery.clear();
+	m_touchGrid.query( position, m_touchQuery );
+	for ( auto i : m_touchQuery ) {
+		zones.push_back( m_indexedTouchZones[i] );
+	}
+	zones.insert( zones.end(), m_unindexedTouchZones.begin(), m_unindexedTouchZones.end() );
+}
+
+void Scene::dispatchTouchZones( TouchEvent& touchEvent )
+{
+	if ( m_touchZones.empty() )
+		return;
+
+	// touches pressed on a capturing zone go straight to it
+	TouchZone* owner = nullptr;
+	if ( touchEvent.type != TouchEvent::Type::PRESS ) {
+		auto it = m_touchOwners.find( touchEvent.id );
+		if ( it != m_touchOwners.end() ) {
+			owner = it->second;
+			owner->handleTouchEvent( touchEvent );
+			if ( touchEvent.captured )
+				return;
+			// i.e. dragged off the owner - continue with a hit test for the other zones
+		}
+	}
+
+	// zones under the touch, plus active zones that need to hear about drags / releases elsewhere
+	m_touchCandidates.clear();
+	collectTouchZones( touchEvent.position, m_touchCandidates );
+	m_touchCandidates.insert( m_touchCandidates.end(), m_activeTouchZones.begin(), m_activeTouchZones.end() );
+	sortByDrawOrder( m_touchCandidates, 0 );
+	std::replace( m_touchCandidates.begin(), m_touchCandidates.end(), owner, ( TouchZone* )nullptr );
+
+	for ( size_t i = 0; i < m_touchCandidates.size(); ++i ) {
+		auto zone = m_touchCandidates[i];
+		if ( !zone )
+			continue;  // removed by a previous zone's callback
+		if ( touchEvent.captured && zone->getIsCapturingTouch() )
+			continue;  // early out - only non-capturing zones see captured events
+		zone->handleTouchEvent( touchEvent );
+	}
+	m_touchCandidates.clear();
+}
+
+void Scene::sortByDrawOrder( std::vector<TouchZone*>& zones, size_t first )
+{
+	auto drawIndex = []( TouchZone* zone ) -> size_t {
+		auto node = zone->getNode();
+		return node ? node->getSceneDrawIndex() : 0;
+	};
+	// lowest touch group, then top-most (last drawn) first, duplicates removed
+	std::sort( zones.begin() + first, zones.end(), [&]( TouchZone* a, TouchZone* b ) {
+		if ( a->getTouchGroup() != b->getTouchGroup() )
+			return a->getTouchGroup() < b->getTouchGroup();
+		auto ia = drawIndex( a ), ib = drawIndex( b );
+		return ia != ib ? ia > ib : a < b;
+	} );
+	zones.erase( std::unique( zones.begin() + first, zones.end() ), zones.end() );
+}
+
+void Scene::flagNodeIndexDirty( Node& node )
+{
+	if ( node.m_touchZoneCount > 0 )
+		m_isTouchIndexDirty = true;
+	if ( node.m_pickBounds )
+		flagPickableMoved( node.m_pickBounds );
+}
+
+void Scene::addPickable( Bounds* bounds )
+{
+	m_pickables.push_back( bounds );
+	m_isPickIndexDirty = true;
+	if ( auto node = bounds->getNode() ) {
+		node->m_pickBounds = bounds;  // so it flags the index when it moves
+		node->flagSceneIndexDirty();  // a zone on this node may now be indexable
+	}
+}
+
+void Scene::removePickable( Bounds* bounds )
+{
+	m_pickables.erase( std::remove( m_pickables.begin(), m_pickables.end(), bounds ), m_pickables.end() );
+	m_movedPickables.erase( std::remove( m_movedPickables.begin(), m_movedPickables.end(), bounds ), m_movedPickables.end() );
+	m_isPickIndexDirty = true;
+	if ( auto node = bounds->getNode() ) {
+		node->flagSceneIndexDirty();
+		if ( node->m_pickBounds == bounds )
+			node->m_pickBounds = nullptr;
+	}
+}
+
+void Scene::flagPickableMoved( Bounds* bounds )
+{
+	if ( m_isPickIndexDirty || bounds->m_isPickMoved )
+		return;  // rebuilding anyway, or already queued
+	bounds->m_isPickMoved = true;
+	m_movedPickables.push_back( bounds );
+}
+
+void Scene::updatePickIndex()
+{
+	auto sceneBounds = []( Bounds* bounds ) {
+		bounds->m_isPickMoved = false;
+		auto node             = bounds->getNode();
+		return node ? node->getSceneBounds() : Bounds3D::empty();  // rebuilds scene matrix if needed
+	};
+
+	if ( m_isPickIndexDirty ) {
+		m_pickBounds.clear();
+		for ( uint32_t i = 0; i < m_pickables.size(); ++i ) {
+			m_pickables[i]->m_pickIndex = i;
+			m_pickBounds.push_back( sceneBounds( m_pickables[i] ) );
+		}
+		m_pickBvh.build( m_pickBounds );
+		m_movedPickables.clear();
+		m_isPickIndexDirty = false;
+		return;
+	}
+
+	// refit only nodes that moved or changed bounds, as flagged by flagNodeIndexDirty()
+	for ( auto bounds : m_movedPickables ) {
+		m_pickBvh.update( bounds->m_pickIndex, sceneBounds( bounds ) );
+	}
+	m_movedPickables.clear();
+}
+
 void Scene::forceAssignDrawIndices()
 {
 	m_drawnNodes.clear();
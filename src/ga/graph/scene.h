@@ -1,16 +1,23 @@
 #pragma once
+#include "ga/bvh.h"
 #include "ga/defines.h"
 #include "ga/events.h"
 #include "ga/graph/node.h"
+#include "ga/latency.h"
 #include "ga/signal.h"
+#include "ga/spatial_grid.h"
 #include "ga/timeout.h"
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace ga {
 
+class Bounds;
+class TouchZone;
+
 /**
  * @brief Scene is a view controller.
  *	- contains a single root node, which holds the scene's node / view hierarchy.
@@ -47,36 +54,246 @@ public:
 	void setName( const std::string& name );
 	const std::string& getName();
 
+	// the clock update() advances, and the scene's timeouts are timed with - getFrameClock() by default
+	void setClock( FrameClock* clock );
+	FrameClock* getClock() const { return m_clock; }
+
+	// fixed rate update
+	// -----------------
+	// when set, update() runs input, timeouts and node updates in fixed steps of 1 / hz seconds,
+	// as many as the clock has moved since the last frame (up to maxStepsPerFrame, dropping the rest),
+	// and each step sees its own time on the clock. draw() then interpolates node transforms
+	// between the last two steps. hz <= 0 switches back to one update per frame.
+	void setFixedUpdateRate( double hz, int maxStepsPerFrame = 5 );
+	double getFixedUpdateRate() const;
+	bool isFixedUpdateEnabled() const { return m_fixedStep > Clock::duration::zero(); }
+
+	float getInterpolationAlpha() const { return m_interpolationAlpha; }  // 0-1 from the previous step to the last one
+	uint32_t getUpdateStep() const { return m_updateStep; }                // steps run so far
+
+	const Node::UpdateStats& getUpdateStats() const { return m_updateStats; }  // from the last update() (or step)
+
 	virtual void handleMouseEvent( MouseEvent& mouseEvent );
-	virtual void handleTouchEvent( TouchEvent& touchEvent );
+	virtual void handleTouchEvent( TouchEvent& touchEvent );  // triggers onTouchEvent, then TouchZones under the touch
 	virtual void handleKeyEvent( KeyEvent& keyEvent );
 
+	// queued input
+	// ------------
+	// when enabled, handle*Event() only buffers events, and update() dispatches them once per frame.
+	// consecutive MOVE / DRAG events from the same pointer are coalesced into the latest one,
+	// which keeps the earlier positions in its 'history'.
+	struct InputStats
+	{
+		size_t received     = 0;   // events passed to handle*Event()
+		size_t dispatched   = 0;   // events dispatched, after coalescing
+		size_t coalesced    = 0;   // events merged into a later event
+		double avgLatencyMs = 0.;  // event time -> dispatch
+		double maxLatencyMs = 0.;
+	};
+
+	void setInputQueueEnabled( bool enabled = true );
+	bool isInputQueueEnabled() const { return m_isInputQueueEnabled; }
+
+	void processInputQueue();  // dispatch buffered events now - called by update()
+
+	const InputStats& getInputStats() const { return m_inputStats; }  // for the frame ending at the last update()
+
+	// input latency
+	// -------------
+	// when enabled, every dispatched input event is followed to the frame that shows its result.
+	// each stage is measured from the event's time (the oldest one, for coalesced events):
+	//	dispatch - scene signals and touch zones called
+	//	update   - end of the first update() after dispatch
+	//	draw     - end of the following draw()
+	//	present  - markFramePresented(), if the app calls it after swapping buffers
+	struct LatencyStats
+	{
+		LatencyHistogram dispatch, update, draw, present;
+	};
+
+	void setLatencyTrackingEnabled( bool enabled = true );
+	bool isLatencyTrackingEnabled() const { return m_isLatencyTrackingEnabled; }
+
+	void markFramePresented();  // call after the frame from the last draw() is on screen
+
+	const LatencyStats& getLatencyStats() const { return m_latencyStats; }  // since tracking was enabled, or reset
+	void resetLatencyStats();
+
+	// touch zones whose scene bounds contain a (scene space) position, top-most (last drawn) first.
+	// zones with inverted or custom bounds tests can't be indexed, so they are always included.
+	void findTouchZones( const vec2& position, std::vector<TouchZone*>& zones );
+
+	// view culling
+	// ------------
+	// when enabled, draw() skips any node (and its children) whose getSceneTreeBounds() is out of view.
+	// nodes with no Bounds in their subtree are never culled.
+	// only Bounds count towards a subtree's bounds, so a node that draws without a Bounds of its own is culled
+	// along with a bounded ancestor that's out of view - every node that draws under a bounded one needs Bounds
+	// (covering what it draws) for culling to be correct.
+	struct CullStats
+	{
+		size_t tested = 0;  // subtrees tested against the view
+		size_t culled = 0;  // subtrees skipped
+	};
+
+	void setCullingEnabled( bool enabled = true ) { m_isCullingEnabled = enabled; }
+	bool isCullingEnabled() const { return m_isCullingEnabled; }
+
+	// cull against a scene space rectangle (i.e. the window), instead of
+	// the frustum of the Renderer's PROJECTION * VIEW * MODEL matrices at draw time
+	void setCullViewport( const Rect& viewport );
+	void clearCullViewport();
+
+	const CullStats& getCullStats() const { return m_cullStats; }  // from the last draw()
+
+	// 3D picking
+	// ----------
+	// ray casts against the Bounds of every node in the scene, as oriented boxes
+	struct PickHit
+	{
+		std::shared_ptr<Node> node;
+		float distance;      // along the ray
+		vec3 scenePosition;  // hit position on the node's Bounds
+		vec3 localPosition;
+	};
+
+	// pick through a window position, using getRenderer().windowPosToRay() - requires Renderer::setViewport()
+	std::vector<PickHit> pick( const vec2& windowPos );
+	// pick with a scene space ray, nearest hit first
+	std::vector<PickHit> pick( const Ray& sceneRay );
+
 	// signals
 	Signal<KeyEvent&> onKeyEvent;
 	Signal<MouseEvent&> onMouseEvent;
 	Signal<TouchEvent&> onTouchEvent;
 
+	// raw input, as passed to handle*Event() - before queuing / coalescing (see InputRecorder)
+	Signal<KeyEvent&> onKeyInput;
+	Signal<MouseEvent&> onMouseInput;
+	Signal<TouchEvent&> onTouchInput;
+
 protected:
 	Scene();
 
+	void updateStep();   // one update of input, timeouts and nodes
 	void updateNodes();  // update root node and all children
 	void drawNodes();    // draw root node and all children
 
+	// trigger event signals / touch zones
+	void dispatchMouseEvent( MouseEvent& mouseEvent );
+	void dispatchTouchEvent( TouchEvent& touchEvent );
+	void dispatchKeyEvent( KeyEvent& keyEvent );
+	void recordDispatch( const TimePoint& eventTime );
+	void trackLatency( std::vector<TimePoint>& from, std::vector<TimePoint>* to, LatencyHistogram& histogram );
+
 	friend void Node::setScene( std::shared_ptr<Scene> scene );
 	//void addToHierarchy( std::shared_ptr<Node> node );
 	//void removeFromHierarchy( std::shared_ptr<Node> node );
 
+	// throttled nodes, bucketed by update interval (see Node::setUpdateRate)
+	friend void Node::setUpdateRate( double hz );
+	void scheduleUpdate( Node* node );
+	void unscheduleUpdate( Node* node );
+	void updateScheduledNodes();
+
 	friend void Node::drawTree();
 	size_t nextDrawIndex( std::shared_ptr<Node> node );
+	bool isCulled( Node& node );
 
 	friend size_t Node::getSceneDrawIndex() const;
 	void forceAssignDrawIndices();
 
+	// touch zone index - zones register themselves
+	friend class TouchZone;
+	friend void Node::flagSceneIndexDirty();
+	void addTouchZone( TouchZone* zone );
+	void removeTouchZone( TouchZone* zone );
+	void setTouchZoneActive( TouchZone* zone, bool isActive );
+	void setTouchOwner( int pointerId, TouchZone* zone );
+	void clearTouchOwner( int pointerId, TouchZone* zone );  // only if owned by zone
+	void flagTouchIndexDirty() { m_isTouchIndexDirty = true; }
+	void flagNodeIndexDirty( Node& node );  // node moved or its Bounds changed
+	void rebuildTouchIndex();
+	void collectTouchZones( const vec2& position, std::vector<TouchZone*>& zones );  // unsorted
+	void dispatchTouchZones( TouchEvent& touchEvent );
+	void sortByDrawOrder( std::vector<TouchZone*>& zones, size_t first );
+
+	// pick index - Bounds components register themselves
+	friend class Bounds;
+	void addPickable( Bounds* bounds );
+	void removePickable( Bounds* bounds );
+	void updatePickIndex();  // rebuild if pickables changed, otherwise refit moved ones
+	void flagPickableMoved( Bounds* bounds );
+
 	std::string m_name;
 	std::shared_ptr<Node> m_rootNode;
 	ga::TimeoutManager m_timeoutManager;
+	FrameClock* m_clock = &getFrameClock();
+
+	Clock::duration m_fixedStep = Clock::duration::zero();
+	int m_maxFixedSteps         = 5;
+	TimePoint m_fixedStepTime;  // clock time of the last step
+	float m_interpolationAlpha = 1.f;
+	uint32_t m_updateStep      = 0;
+
+	struct UpdateBucket
+	{
+		Clock::duration interval;
+		TimePoint nextTime;
+		std::vector<Node*> nodes;
+	};
+	std::vector<UpdateBucket> m_updateBuckets;
+	std::vector<Node*> m_dueNodes;  // scratch
+	Node::UpdateStats m_updateStats;
 
 	std::vector<std::weak_ptr<Node>> m_drawnNodes;  // sorted by draw order
+
+	bool m_isCullingEnabled = false;
+	bool m_hasCullViewport  = false;
+	Rect m_cullViewport;
+	Frustum m_cullFrustum;
+	CullStats m_cullStats;
+
+	std::vector<TouchZone*> m_touchZones;           // all registered zones
+	std::vector<TouchZone*> m_indexedTouchZones;    // zones in m_touchGrid, by grid item index
+	std::vector<TouchZone*> m_unindexedTouchZones;  // always tested
+	std::vector<TouchZone*> m_activeTouchZones;     // always receive events, i.e. for DRAG_OFF / RELEASE
+	std::unordered_map<int, TouchZone*> m_touchOwners;  // pointer id -> capturing zone that was pressed
+	std::vector<TouchZone*> m_touchCandidates;      // dispatch scratch
+	std::vector<Bounds3D> m_touchZoneBounds;        // rebuild scratch
+	std::vector<uint32_t> m_touchQuery;             // query scratch
+	SpatialGrid m_touchGrid;
+	bool m_isTouchIndexDirty = true;
+
+	// input queue - events are stored by type, and ordered by m_inputQueue
+	struct QueuedInput
+	{
+		enum class Type
+		{
+			KEY,
+			MOUSE,
+			TOUCH
+		} type;
+		size_t index;         // into the event vector for this type
+		TimePoint firstTime;  // of the oldest coalesced event
+	};
+	bool m_isInputQueueEnabled = false;
+	std::vector<QueuedInput> m_inputQueue, m_processingInputQueue;
+	std::vector<KeyEvent> m_queuedKeyEvents, m_processingKeyEvents;
+	std::vector<MouseEvent> m_queuedMouseEvents, m_processingMouseEvents;
+	std::vector<TouchEvent> m_queuedTouchEvents, m_processingTouchEvents;
+	InputStats m_inputStats, m_frameInputStats;
+	double m_frameLatencySumMs = 0.;
+
+	bool m_isLatencyTrackingEnabled = false;
+	LatencyStats m_latencyStats;
+	std::vector<TimePoint> m_latencyDispatched, m_latencyUpdated, m_latencyDrawn;  // event times waiting for the next stage
+
+	std::vector<Bounds*> m_pickables;       // by bvh item index
+	std::vector<Bounds*> m_movedPickables;  // to refit on the next pick
+	std::vector<Bounds3D> m_pickBounds;     // rebuild scratch
+	Bvh m_pickBvh;
+	bool m_isPickIndexDirty = true;
 };
 
 // template implementations
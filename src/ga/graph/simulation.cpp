@@ -0,0 +1,50 @@
+#include "ga/graph/simulation.h"
+#include "ga/graph/scene.h"
+#include <cmath>
+
+namespace ga {
+
+Simulation::Simulation( std::shared_ptr<Scene> scene )
+    : m_scene( scene )
+{
+}
+
+Simulation::Report Simulation::run( size_t frames, double dt )
+{
+	Report report;
+	auto clock = m_scene ? m_scene->getClock() : nullptr;
+	if ( !clock )
+		return report;
+
+	bool wasManual = clock->isManual();
+	clock->setManual( true );
+	auto start = Clock::now();
+
+	for ( size_t i = 0; i < frames; ++i ) {
+		clock->step( dt );
+		auto t0 = Clock::now();
+		m_scene->update();
+		auto t1 = Clock::now();
+		report.updateTime.add( t0, t1 );
+		if ( m_isDrawEnabled ) {
+			m_scene->draw();
+			report.drawTime.add( t1, Clock::now() );
+		}
+		++report.frames;
+		report.simulatedSeconds += dt;
+		onFrame( i );
+	}
+
+	report.durationMs = std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+	clock->setManual( wasManual );
+	return report;
+}
+
+Simulation::Report Simulation::runFor( double seconds, double dt )
+{
+	if ( dt <= 0. )
+		return Report();
+	return run( ( size_t )std::ceil( seconds / dt - 1e-6 ), dt );  // tolerate rounding, i.e. 1 / 60.
+}
+
+}  // namespace ga
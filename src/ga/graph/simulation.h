@@ -0,0 +1,45 @@
+#pragma once
+#include "ga/latency.h"
+#include "ga/signal.h"
+#include "ga/timer.h"
+#include <memory>
+
+namespace ga {
+
+class Scene;
+
+/**
+ * @brief Simulation runs a Scene offline, at a fixed time step and as fast as the CPU allows.
+ *
+ * The scene's clock is switched to manual while running, so every Timer, Tween and Timeout on it
+ * sees exactly frames * dt pass, and the same run always produces the same frames.
+ */
+class Simulation
+{
+public:
+	struct Report
+	{
+		size_t frames           = 0;
+		double simulatedSeconds = 0.;
+		double durationMs       = 0.;  // wall time
+		LatencyHistogram updateTime, drawTime;
+	};
+
+	Simulation( std::shared_ptr<Scene> scene );
+
+	// step frames of dt seconds - update(), then draw() if enabled, then onFrame
+	Report run( size_t frames, double dt );
+	Report runFor( double seconds, double dt );
+
+	void setDrawEnabled( bool enabled = true ) { m_isDrawEnabled = enabled; }
+	bool isDrawEnabled() const { return m_isDrawEnabled; }
+
+	// after each frame, with the frame number - i.e. to dump the frame
+	Signal<size_t> onFrame;
+
+protected:
+	std::shared_ptr<Scene> m_scene;
+	bool m_isDrawEnabled = false;
+};
+
+}  // namespace ga
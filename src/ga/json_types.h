@@ -1,5 +1,6 @@
 #pragma once
 #include "ga/json.h"
+#include "ga/latency.h"
 
 // ---------------- json conversions ----------------
 
@@ -104,6 +105,20 @@ inline void to_json( ga::Json& j, const ga::mat4& m )
 	}
 }
 
+// ga::LatencyHistogram - summary and buckets, export only
+inline void to_json( ga::Json& j, const ga::LatencyHistogram& h )
+{
+	j = { { "count", h.count() },
+	      { "avgMs", h.avgMs() },
+	      { "minMs", h.minMs() },
+	      { "maxMs", h.maxMs() },
+	      { "p50Ms", h.p50() },
+	      { "p95Ms", h.p95() },
+	      { "p99Ms", h.p99() },
+	      { "bucketMs", h.getBucketMs() },
+	      { "buckets", h.getBuckets() } };
+}
+
 // ga::Transform
 //inline void from_json(const ga::Json& j, ga::Transform& t)
 //{
@@ -0,0 +1,250 @@
+#pragma once
+#include "ga/easing.h"
+#include "ga/math.h"
+#include "ga/timer.h"
+#include "ga/tween.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace ga {
+
+// one key of a KeyframeTrack - its ease shapes the segment arriving at this key
+template <typename T>
+struct Keyframe
+{
+	double time;  // seconds from the start of the track
+	T value;
+	EaseType ease   = EaseType::LINEAR;
+	EasingFn easeFn = nullptr;  // EaseType::CUSTOM only
+};
+
+/**
+ * @brief KeyframeTrack is a list of (time, value, ease) keys, for any T supported by ga::lerp().
+ *
+ * A track is immutable once built, so one track can be shared by any number of KeyframeTweens:
+ *
+ *		auto bounce = KeyframeTrack<vec3>::create( { { 0., vec3( 0 ) }, { .3, vec3( 0, 40, 0 ), EaseType::EXPO_OUT }, { .6, vec3( 0 ) } } );
+ */
+template <typename T>
+class KeyframeTrack
+{
+public:
+	// keys are sorted by time (keys with equal times keep their order, for steps)
+	KeyframeTrack( std::vector<Keyframe<T>> keys )
+	    : m_keys( std::move( keys ) )
+	{
+		std::stable_sort( m_keys.begin(), m_keys.end(), []( const Keyframe<T>& a, const Keyframe<T>& b ) { return a.time < b.time; } );
+	}
+
+	static std::shared_ptr<const KeyframeTrack> create( std::vector<Keyframe<T>> keys )
+	{
+		return std::make_shared<const KeyframeTrack>( std::move( keys ) );
+	}
+
+	const std::vector<Keyframe<T>>& getKeys() const { return m_keys; }
+	bool empty() const { return m_keys.empty(); }
+
+	double getStartTime() const { return m_keys.empty() ? 0. : m_keys.front().time; }
+	double getDuration() const { return m_keys.empty() ? 0. : m_keys.back().time; }  // from time 0
+
+	// the value at 'time' - clamped to the first and last keys, T() if there are none
+	// 'cursor' is the caller's segment index, reused between calls: steady forward playback is O(1), seeking is O(log n)
+	T sample( double time, size_t& cursor ) const
+	{
+		if ( m_keys.empty() )
+			return T();
+		if ( time <= m_keys.front().time )
+			return m_keys.front().value;
+		if ( time >= m_keys.back().time )
+			return m_keys.back().value;
+
+		cursor = findSegment( time, cursor );
+		auto& a  = m_keys[cursor];
+		auto& b  = m_keys[cursor + 1];
+		auto dur = b.time - a.time;
+		if ( dur <= 0. )
+			return b.value;
+		float pct = float( ( time - a.time ) / dur );
+		pct       = b.ease == EaseType::CUSTOM ? ( b.easeFn ? b.easeFn( pct ) : pct ) : applyEase( b.ease, pct );
+		return ga::lerp( a.value, b.value, pct );
+	}
+
+	T sample( double time ) const
+	{
+		size_t cursor = 0;
+		return sample( time, cursor );
+	}
+
+protected:
+	// index i of the segment with keys[i].time <= time < keys[i + 1].time (time is inside the track)
+	size_t findSegment( double time, size_t cursor ) const
+	{
+		size_t last = m_keys.size() - 1;
+		if ( cursor < last && m_keys[cursor].time <= time ) {
+			// step forward a few keys, then give up and search
+			for ( int i = 0; i < 4 && cursor < last; ++i, ++cursor ) {
+				if ( time < m_keys[cursor + 1].time )
+					return cursor;
+			}
+		}
+		auto it = std::upper_bound( m_keys.begin(), m_keys.end(), time, []( double t, const Keyframe<T>& key ) { return t < key.time; } );
+		return size_t( it - m_keys.begin() ) - 1;
+	}
+
+	std::vector<Keyframe<T>> m_keys;
+};
+
+/**
+ * @brief KeyframeTween plays a shared KeyframeTrack, with the Tween interface - bind, onDone, and adding to a Timeline.
+ */
+template <typename T>
+class KeyframeTween : public TweenBase, public Timer
+{
+public:
+	friend class Timeline;
+
+	KeyframeTween( std::shared_ptr<const KeyframeTrack<T>> track = nullptr, Callback onDone = nullptr )
+	    : Timer()
+	    , m_onDone( std::move( onDone ) )
+	{
+		setTrack( track );
+	}
+
+	KeyframeTween& setTrack( std::shared_ptr<const KeyframeTrack<T>> track )
+	{
+		m_track  = track;
+		m_cursor = 0;
+		m_val    = m_track ? m_track->sample( 0. ) : T();
+		return *this;
+	}
+	const std::shared_ptr<const KeyframeTrack<T>>& getTrack() const { return m_track; }
+
+	// assign callback on done
+	KeyframeTween& setOnDone( Callback onDone )
+	{
+		m_onDone = std::move( onDone );
+		return *this;
+	}
+
+	// bind a ptr to update with the animation value
+	KeyframeTween& bind( T* ptr )
+	{
+		m_boundPtr = ptr;
+		return *this;
+	}
+	// bind a property (i.e. node->getTranslationProperty()) - safe if its owner is destroyed first
+	KeyframeTween& bind( Property<T> property )
+	{
+		m_boundProperty = property;
+		return *this;
+	}
+	KeyframeTween& unbind()
+	{
+		m_boundPtr = nullptr;
+		m_boundProperty.reset();
+		return *this;
+	}
+
+	const T& getValue() const { return m_val; }
+
+	// plays the track at its own speed
+	virtual void startNow() override
+	{
+		auto now = Timer::now();
+		Timer::set( now, now + std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( getTrackDuration() ) ) );
+		m_cursor = 0;
+	}
+
+	// plays the whole track in 'durationMillis'
+	virtual void startNow( long durationMillis ) override
+	{
+		Timer::startNow( durationMillis );
+		m_cursor = 0;
+	}
+
+	void startAfterDelay( long delayMs )
+	{
+		startNow();
+		auto offset = ga::Millis( delayMs );
+		Timer::set( mBegin_t + offset, mEnd_t + offset );
+	}
+
+	// update and return current value (call at frame rate when using bound ptr)
+	const T& update()
+	{
+		update_();
+		if ( Timer::isDone() ) {
+			end();
+		}
+		return m_val;
+	}
+
+	// end animation now (optionally firing callback), return end value
+	const T& endNow( bool fireCallback = true )
+	{
+		end( fireCallback );
+		return m_val;
+	}
+
+	// jump to 'pct' (0-1) of the track, regardless of the timer and without callbacks (i.e. for scrubbing)
+	const T& seek( float pct )
+	{
+		if ( m_track )
+			m_val = m_track->sample( ga::clamp( pct, 0.f, 1.f ) * getTrackDuration(), m_cursor );
+		updateBoundPtr();
+		return m_val;
+	}
+
+protected:
+	std::shared_ptr<const KeyframeTrack<T>> m_track;
+	size_t m_cursor = 0;
+	T m_val;
+	Callback m_onDone;
+	T* m_boundPtr = nullptr;
+	Property<T> m_boundProperty;
+
+	double getTrackDuration() const { return m_track ? m_track->getDuration() : 0.; }
+
+	void updateBoundPtr()
+	{
+		if ( m_boundPtr )
+			*m_boundPtr = m_val;
+		m_boundProperty.set( m_val );
+	}
+
+	void end( bool fireCallback = true ) override
+	{
+		if ( m_track )
+			m_val = m_track->sample( getTrackDuration(), m_cursor );
+		updateBoundPtr();
+		Timer::clear();
+		if ( fireCallback && m_onDone ) {
+			try {
+				m_onDone();
+			} catch ( std::exception& e ) {
+				// todo: log exception
+				m_onDone = nullptr;  // clear callback since it's broken
+			}
+		}
+	}
+
+	bool update_() override
+	{
+		if ( !m_track || !Timer::isSet() )
+			return false;
+		if ( Timer::isActive() ) {
+			m_val = m_track->sample( Timer::elapsedPercent() * getTrackDuration(), m_cursor );
+		} else if ( Timer::isDone() ) {
+			m_val = m_track->sample( getTrackDuration(), m_cursor );
+		}
+		updateBoundPtr();
+		return !Timer::isDone();
+	}
+
+	bool isDone_() override { return Timer::isDone(); }
+	bool isStarted_() override { return Timer::isStarted(); }
+	void seek_( float pct ) override { seek( pct ); }
+};
+
+}  // namespace ga
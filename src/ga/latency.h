@@ -0,0 +1,109 @@
+#pragma once
+#include "ga/math.h"
+#include "ga/timer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace ga {
+
+/**
+ * @brief LatencyHistogram counts durations in fixed width millisecond buckets, for percentiles.
+ *
+ * Adding a sample is O(1) and never allocates, so it can run every frame.
+ * Samples past the last bucket are counted in an overflow bucket, and reported as the max.
+ */
+class LatencyHistogram
+{
+public:
+	LatencyHistogram( double bucketMs = 0.5, size_t numBuckets = 1000 )
+	    : m_bucketMs( bucketMs )
+	    , m_buckets( numBuckets + 1, 0 )
+	{
+	}
+
+	void add( double ms )
+	{
+		ms         = std::max( ms, 0. );
+		size_t i   = std::min( ( size_t )( ms / m_bucketMs ), m_buckets.size() - 1 );
+		m_minMs    = m_count ? std::min( m_minMs, ms ) : ms;
+		m_maxMs    = std::max( m_maxMs, ms );
+		m_sumMs   += ms;
+		++m_buckets[i];
+		++m_count;
+	}
+
+	void add( const TimePoint& begin, const TimePoint& end )
+	{
+		add( std::chrono::duration<double, std::milli>( end - begin ).count() );
+	}
+
+	void merge( const LatencyHistogram& other )
+	{
+		if ( !other.m_count )
+			return;
+		if ( other.m_buckets.size() != m_buckets.size() || other.m_bucketMs != m_bucketMs ) {
+			std::cerr << "LatencyHistogram::merge() - bucket layouts differ" << std::endl;
+			return;
+		}
+		for ( size_t i = 0; i < m_buckets.size(); ++i ) {
+			m_buckets[i] += other.m_buckets[i];
+		}
+		m_minMs  = m_count ? std::min( m_minMs, other.m_minMs ) : other.m_minMs;
+		m_maxMs  = std::max( m_maxMs, other.m_maxMs );
+		m_sumMs += other.m_sumMs;
+		m_count += other.m_count;
+	}
+
+	void clear()
+	{
+		std::fill( m_buckets.begin(), m_buckets.end(), 0 );
+		m_count = 0;
+		m_sumMs = m_minMs = m_maxMs = 0.;
+	}
+
+	// upper edge of the bucket holding the p-th percentile (0-100), clamped to the max sample
+	double percentile( double p ) const
+	{
+		if ( !m_count )
+			return 0.;
+		uint64_t rank = ( uint64_t )std::ceil( ga::clamp( p, 0., 100. ) / 100. * m_count );
+		rank          = std::max( rank, ( uint64_t )1 );
+		uint64_t seen = 0;
+		for ( size_t i = 0; i < m_buckets.size() - 1; ++i ) {
+			seen += m_buckets[i];
+			if ( seen >= rank )
+				return std::min( ( i + 1 ) * m_bucketMs, m_maxMs );
+		}
+		return m_maxMs;
+	}
+
+	double p50() const { return percentile( 50. ); }
+	double p95() const { return percentile( 95. ); }
+	double p99() const { return percentile( 99. ); }
+
+	uint64_t count() const { return m_count; }
+	double minMs() const { return m_minMs; }
+	double maxMs() const { return m_maxMs; }
+	double avgMs() const { return m_count ? m_sumMs / m_count : 0.; }
+
+	double getBucketMs() const { return m_bucketMs; }
+	const std::vector<uint64_t>& getBuckets() const { return m_buckets; }  // last one is overflow
+
+protected:
+	double m_bucketMs;
+	std::vector<uint64_t> m_buckets;
+	uint64_t m_count = 0;
+	double m_sumMs = 0., m_minMs = 0., m_maxMs = 0.;
+};
+
+// summary line, i.e. "n=120 avg=18.2 p50=17.5 p95=24 p99=31 max=33.1 (ms)"
+inline std::ostream& operator<<( std::ostream& stream, const LatencyHistogram& histogram )
+{
+	return stream << "n=" << histogram.count() << " avg=" << histogram.avgMs() << " p50=" << histogram.p50() << " p95=" << histogram.p95()
+	              << " p99=" << histogram.p99() << " max=" << histogram.maxMs() << " (ms)";
+}
+
+}  // namespace ga
@@ -4,12 +4,18 @@
 #include "glm/gtx/matrix_decompose.hpp"  // needed for matrix decomposition
 #include "glm/gtx/quaternion.hpp"
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 #ifdef GA_OPENFRAMEWORKS
 #include "ofRectangle.h"
 #endif
 
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#include <xmmintrin.h>
+#define GA_SSE
+#endif
+
 namespace ga {
 
 namespace math {
@@ -54,6 +60,42 @@ inline double toRadians( const double& degrees )
 	return math::degToRadFactor * degrees;
 }
 
+/**
+ * @brief Transform an array of points by an affine matrix (no perspective divide).
+ * 
+ * 'in' and 'out' may be the same array.
+ */
+inline void transformPoints( const mat4& m, const vec3* in, vec3* out, size_t count )
+{
+#ifdef GA_SSE
+	// out = col0 * x + col1 * y + col2 * z + col3, 4 lanes at a time
+	const float* p = &m[0][0];
+	__m128 c0      = _mm_loadu_ps( p );
+	__m128 c1      = _mm_loadu_ps( p + 4 );
+	__m128 c2      = _mm_loadu_ps( p + 8 );
+	__m128 c3      = _mm_loadu_ps( p + 12 );
+	alignas( 16 ) float r[4];
+	for ( size_t i = 0; i < count; ++i ) {
+		__m128 xy = _mm_add_ps( _mm_mul_ps( c0, _mm_set1_ps( in[i].x ) ), _mm_mul_ps( c1, _mm_set1_ps( in[i].y ) ) );
+		__m128 zw = _mm_add_ps( _mm_mul_ps( c2, _mm_set1_ps( in[i].z ) ), c3 );
+		_mm_store_ps( r, _mm_add_ps( xy, zw ) );
+		out[i] = vec3( r[0], r[1], r[2] );
+	}
+#else
+	// hoisted so the compiler can keep the matrix in registers and vectorize
+	const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+	const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+	const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+	const float m30 = m[3][0], m31 = m[3][1], m32 = m[3][2];
+	for ( size_t i = 0; i < count; ++i ) {
+		const float x = in[i].x, y = in[i].y, z = in[i].z;
+		out[i] = vec3( m00 * x + m10 * y + m20 * z + m30,
+		               m01 * x + m11 * y + m21 * z + m31,
+		               m02 * x + m12 * y + m22 * z + m32 );
+	}
+#endif
+}
+
 /**
  * @brief A 2D axis-aligned rectangle, with x,y (float) position and w,h (float) size components.  
  *   
@@ -123,11 +165,149 @@ struct Rect
 struct Bounds3D
 {
 	vec3 min, max;
+
+	// an "inverted" box that contains nothing - use as the starting point for include()
+	static Bounds3D empty() { return { vec3( std::numeric_limits<float>::max() ), vec3( std::numeric_limits<float>::lowest() ) }; }
+
 	vec3 center() const { return ( min + max ) * .5f; }
 	vec3 size() const { return max - min; }
 	float width() const { return max.x - min.x; }
 	float height() const { return max.y - min.y; }
 	float depth() const { return max.z - min.z; }
+
+	bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+	Bounds3D& include( const vec3& pt )
+	{
+		min = glm::min( min, pt );
+		max = glm::max( max, pt );
+		return *this;
+	}
+
+	Bounds3D& include( const Bounds3D& other )
+	{
+		min = glm::min( min, other.min );
+		max = glm::max( max, other.max );
+		return *this;
+	}
+
+	bool contains( const vec3& pt ) const
+	{
+		return pt.x >= min.x && pt.y >= min.y && pt.z >= min.z && pt.x <= max.x && pt.y <= max.y && pt.z <= max.z;
+	}
+
+	bool intersects( const Bounds3D& other ) const
+	{
+		return min.x <= other.max.x && min.y <= other.max.y && min.z <= other.max.z
+		       && max.x >= other.min.x && max.y >= other.min.y && max.z >= other.min.z;
+	}
+
+	// axis-aligned box enclosing this box after an affine transformation
+	// (transforms center + extents, instead of all 8 corners - see Arvo, Graphics Gems 1990)
+	Bounds3D transformed( const mat4& m ) const
+	{
+		if ( isEmpty() )
+			return *this;
+		vec3 c = m * vec4( center(), 1.f );
+		vec3 e = size() * .5f;
+		vec3 r = glm::abs( vec3( m[0] ) ) * e.x + glm::abs( vec3( m[1] ) ) * e.y + glm::abs( vec3( m[2] ) ) * e.z;
+		return { c - r, c + r };
+	}
+};
+
+/**
+ * @brief A ray, with an origin and direction.
+ * 
+ * Distances along the ray are in units of the direction's length.
+ */
+struct Ray
+{
+	vec3 origin, direction;
+
+	vec3 at( float t ) const { return origin + direction * t; }
+
+	// an affine transformation of the ray - distances stay the same, since direction is not re-normalized
+	Ray transformed( const mat4& m ) const { return { vec3( m * vec4( origin, 1.f ) ), vec3( m * vec4( direction, 0.f ) ) }; }
+
+	// slab test - returns the entry distance (0 if the origin is inside) in 't', ignoring boxes behind the origin
+	bool intersects( const Bounds3D& box, float& t ) const
+	{
+		float tMin = 0.f;
+		float tMax = std::numeric_limits<float>::max();
+		for ( int i = 0; i < 3; ++i ) {
+			if ( std::abs( direction[i] ) < std::numeric_limits<float>::epsilon() ) {
+				// parallel to this slab
+				if ( origin[i] < box.min[i] || origin[i] > box.max[i] )
+					return false;
+				continue;
+			}
+			float inv = 1.f / direction[i];
+			float t0  = ( box.min[i] - origin[i] ) * inv;
+			float t1  = ( box.max[i] - origin[i] ) * inv;
+			if ( t0 > t1 )
+				std::swap( t0, t1 );
+			tMin = std::max( tMin, t0 );
+			tMax = std::min( tMax, t1 );
+			if ( tMin > tMax )
+				return false;
+		}
+		t = tMin;
+		return true;
+	}
+};
+
+/**
+ * @brief A view frustum, stored as 6 planes (xyz = normal, w = distance).
+ * 
+ * A point is inside a plane when dot( normal, pt ) + distance >= 0
+ */
+struct Frustum
+{
+	vec4 planes[6];
+
+	// extract the planes from a (projection * view * model) matrix - Gribb & Hartmann
+	static Frustum fromMatrix( const mat4& m )
+	{
+		// glm is column major, so m[col][row]
+		auto row = [&m]( int i ) { return vec4( m[0][i], m[1][i], m[2][i], m[3][i] ); };
+		Frustum f;
+		f.planes[0] = row( 3 ) + row( 0 );  // left
+		f.planes[1] = row( 3 ) - row( 0 );  // right
+		f.planes[2] = row( 3 ) + row( 1 );  // bottom
+		f.planes[3] = row( 3 ) - row( 1 );  // top
+		f.planes[4] = row( 3 ) + row( 2 );  // near
+		f.planes[5] = row( 3 ) - row( 2 );  // far
+		return f;
+	}
+
+	// a 2D "frustum" from a rectangle in the xy plane, unbounded in z
+	static Frustum fromRect( const Rect& rect )
+	{
+		vec2 a = rect.min();
+		vec2 b = rect.max();
+		Frustum f;
+		f.planes[0] = vec4( 1.f, 0.f, 0.f, -a.x );
+		f.planes[1] = vec4( -1.f, 0.f, 0.f, b.x );
+		f.planes[2] = vec4( 0.f, 1.f, 0.f, -a.y );
+		f.planes[3] = vec4( 0.f, -1.f, 0.f, b.y );
+		f.planes[4] = vec4( 0.f, 0.f, 0.f, 1.f );
+		f.planes[5] = vec4( 0.f, 0.f, 0.f, 1.f );
+		return f;
+	}
+
+	// false if the box is fully outside any plane (conservative - may return true for boxes just outside a corner)
+	bool intersects( const Bounds3D& b ) const
+	{
+		for ( auto& p : planes ) {
+			// test the box corner furthest along the plane normal
+			vec3 corner( p.x >= 0.f ? b.max.x : b.min.x,
+			             p.y >= 0.f ? b.max.y : b.min.y,
+			             p.z >= 0.f ? b.max.z : b.min.z );
+			if ( p.x * corner.x + p.y * corner.y + p.z * corner.z + p.w < 0.f )
+				return false;
+		}
+		return true;
+	}
 };
 
 /**
@@ -257,10 +437,103 @@ inline float cubicBezier( float x, float x1, float y1, float x2, float y2 )
 	return yFromT( currentt, E, F, G, H );
 }
 
+/**
+ * @brief CubicBezierEase is a cubic-bezier() curve with its coefficients and an x -> t table precomputed,
+ * so evaluating it is a table lookup and one Newton step, instead of solving from scratch (like WebKit's UnitBezier).
+ *
+ * Construct once, i.e. as a static, and call like an ease function - x1 and x2 should be in 0-1, as in CSS.
+ */
+class CubicBezierEase
+{
+public:
+	CubicBezierEase( float x1, float y1, float x2, float y2 )
+	{
+		// polynomial coefficients, with (0,0) and (1,1) as the end points
+		m_cx = 3.f * x1;
+		m_bx = 3.f * ( x2 - x1 ) - m_cx;
+		m_ax = 1.f - m_cx - m_bx;
+		m_cy = 3.f * y1;
+		m_by = 3.f * ( y2 - y1 ) - m_cy;
+		m_ay = 1.f - m_cy - m_by;
+
+		// t for evenly spaced x
+		for ( int i = 0; i < s_tableSize; ++i ) {
+			m_table[i] = solveT( float( i ) / ( s_tableSize - 1 ) );
+		}
+	}
+
+	float operator()( float x ) const
+	{
+		if ( x <= 0.f )
+			return 0.f;
+		if ( x >= 1.f )
+			return 1.f;
+
+		// interpolate t from the table, then refine it - one Newton step, except where the curve is near vertical
+		float pos = x * ( s_tableSize - 1 );
+		int i     = std::min( int( pos ), s_tableSize - 2 );
+		float t   = m_table[i] + ( m_table[i + 1] - m_table[i] ) * ( pos - i );
+		float dx  = sampleDerivativeX( t );
+		if ( std::abs( dx ) > 1e-3f ) {
+			t = clamp( t - ( sampleX( t ) - x ) / dx, m_table[i], m_table[i + 1] );
+			if ( std::abs( sampleX( t ) - x ) < 1e-6f )
+				return sampleY( t );
+		}
+		return sampleY( bisectT( x, m_table[i], m_table[i + 1] ) );
+	}
+
+	// solve for t given x, to full precision (Newton, falling back to bisection)
+	float solveT( float x ) const
+	{
+		float t = x;
+		for ( int i = 0; i < 8; ++i ) {
+			float error = sampleX( t ) - x;
+			if ( std::abs( error ) < 1e-7f )
+				return t;
+			float dx = sampleDerivativeX( t );
+			if ( std::abs( dx ) < 1e-6f )
+				break;
+			t = clamp( t - error / dx, 0.f, 1.f );
+		}
+		return bisectT( x, 0.f, 1.f );
+	}
+
+protected:
+	static const int s_tableSize = 65;  // 64 segments
+
+	// t for x, with t somewhere in lo-hi
+	float bisectT( float x, float lo, float hi ) const
+	{
+		float t = ( hi - lo ) * .5f + lo;
+		while ( lo < hi ) {
+			float sx = sampleX( t );
+			if ( std::abs( sx - x ) < 1e-7f )
+				return t;
+			if ( x > sx )
+				lo = t;
+			else
+				hi = t;
+			float mid = ( hi - lo ) * .5f + lo;
+			if ( mid == t )
+				break;  // float precision exhausted
+			t = mid;
+		}
+		return t;
+	}
+
+	float sampleX( float t ) const { return ( ( m_ax * t + m_bx ) * t + m_cx ) * t; }
+	float sampleY( float t ) const { return ( ( m_ay * t + m_by ) * t + m_cy ) * t; }
+	float sampleDerivativeX( float t ) const { return ( 3.f * m_ax * t + 2.f * m_bx ) * t + m_cx; }
+
+	float m_ax, m_bx, m_cx;
+	float m_ay, m_by, m_cy;
+	float m_table[s_tableSize];
+};
+
 // templated interpolation
-// use an ease function to interpolate from one value to another
-template <typename T>
-inline T interpolate( const T& a, const T& b, float pct, std::function<float( float )> easeFn, bool bClamp = false )
+// use an ease function (a std::function or any functor) to interpolate from one value to another
+template <typename T, typename EaseFn>
+inline T interpolate( const T& a, const T& b, float pct, const EaseFn& easeFn, bool bClamp = false )
 {
 	pct = bClamp ? ga::clamp( easeFn( pct ), 0.f, 1.f ) : easeFn( pct );  // use easing on the pct
 	return ga::lerp( a, b, pct );                                         // then lerp based on eased pct
@@ -0,0 +1,428 @@
+#pragma once
+#include "ga/easing.h"
+#include "ga/math.h"
+#include "ga/property.h"
+#include "ga/timer.h"
+#include "ga/tween.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace ga {
+
+// a point on a Path
+template <typename T>
+struct PathSample
+{
+	T position;
+	T tangent;  // unit direction of travel (zero on an empty path)
+};
+
+// the rotation turning +x to a path's tangent - about the z axis, for 2d paths
+inline quat getPathOrientation( const vec2& tangent )
+{
+	return glm::angleAxis( std::atan2( tangent.y, tangent.x ), vec3( 0.f, 0.f, 1.f ) );
+}
+inline quat getPathOrientation( const vec3& tangent )
+{
+	return glm::dot( tangent, tangent ) > 1e-12f ? glm::rotation( vec3( 1.f, 0.f, 0.f ), glm::normalize( tangent ) ) : quat();
+}
+
+/**
+ * @brief Path is a continuous run of line and cubic bezier segments (vec2 or vec3), sampled by distance.
+ *
+ * Each segment appends to an arc length table as it's added, so sampling is a table lookup and one
+ * bezier evaluation - moving along it at a constant speed, without integrating the curve every frame.
+ * Build it once and share it between any number of PathTweens:
+ *
+ *		auto path = std::make_shared<Path<vec2>>( vec2( 0 ) );
+ *		path->lineTo( vec2( 100, 0 ) ).cubicTo( vec2( 200, 0 ), vec2( 200, 100 ), vec2( 100, 100 ) ).close();
+ */
+template <typename T>
+class Path
+{
+public:
+	// 'curveSubdivisions' is the number of arc length table entries per curve - more is smoother speed
+	explicit Path( const T& start = T( 0.f ), int curveSubdivisions = 16 )
+	    : m_start( start )
+	    , m_curveSubdivisions( std::max( curveSubdivisions, 1 ) )
+	{
+	}
+
+	// a polyline through 'points'
+	explicit Path( const std::vector<T>& points )
+	    : Path( points.empty() ? T( 0.f ) : points.front() )
+	{
+		for ( size_t i = 1; i < points.size(); ++i ) {
+			lineTo( points[i] );
+		}
+	}
+
+	Path& lineTo( const T& point )
+	{
+		// a cubic with its controls at thirds is a line, moving at constant speed
+		auto& p0 = getEnd();
+		addSegment( { p0, ga::lerp( p0, point, 1.f / 3.f ), ga::lerp( p0, point, 2.f / 3.f ), point }, 1 );
+		return *this;
+	}
+
+	Path& quadTo( const T& control, const T& point )
+	{
+		auto& p0 = getEnd();
+		return cubicTo( ga::lerp( p0, control, 2.f / 3.f ), ga::lerp( point, control, 2.f / 3.f ), point );
+	}
+
+	Path& cubicTo( const T& control1, const T& control2, const T& point )
+	{
+		addSegment( { getEnd(), control1, control2, point }, m_curveSubdivisions );
+		return *this;
+	}
+
+	// line back to the start
+	Path& close() { return lineTo( m_start ); }
+
+	void clear()
+	{
+		m_segments.clear();
+		m_distances.clear();
+		m_entrySegments.clear();
+		m_entryParams.clear();
+		m_entrySpeeds.clear();
+	}
+
+	const T& getStart() const { return m_start; }
+	const T& getEnd() const { return m_segments.empty() ? m_start : m_segments.back().p1; }
+
+	size_t getNumSegments() const { return m_segments.size(); }
+	bool empty() const { return m_segments.empty(); }
+	float getLength() const { return m_distances.empty() ? 0.f : m_distances.back(); }
+
+	// the point 'distance' along the path (clamped to its ends)
+	// 'cursor' is the caller's table index, reused between calls: steady forward motion is O(1), seeking is O(log n)
+	PathSample<T> sample( float distance, size_t& cursor ) const
+	{
+		if ( m_segments.empty() )
+			return { m_start, T( 0.f ) };
+
+		distance = ga::clamp( distance, 0.f, getLength() );
+		cursor   = findEntry( distance, cursor );
+
+		float d0  = m_distances[cursor];
+		float d1  = m_distances[cursor + 1];
+		float u0  = m_entryParams[cursor];
+		float u1  = m_entryParams[cursor + 1];
+		float pct = d1 > d0 ? ( distance - d0 ) / ( d1 - d0 ) : 0.f;
+		if ( pct > 0.f && pct < 1.f ) {
+			float scale = ( u1 - u0 ) / ( d1 - d0 );
+			pct         = invertDistance( pct, m_entrySpeeds[cursor] * scale, m_entrySpeeds[cursor + 1] * scale );
+		}
+		float u = ga::lerp( u0, u1, pct );
+
+		auto& segment = m_segments[m_entrySegments[cursor + 1]];
+		T tangent     = derivative( segment, u );
+		if ( glm::dot( tangent, tangent ) < 1e-12f )
+			tangent = segment.p1 - segment.p0;  // i.e. at a control point on an end
+		float len = glm::length( tangent );
+		return { evaluate( segment, u ), len > 0.f ? tangent / len : T( 0.f ) };
+	}
+
+	PathSample<T> sample( float distance ) const
+	{
+		size_t cursor = 0;
+		return sample( distance, cursor );
+	}
+
+	// 'pct' (0-1) of the length
+	PathSample<T> samplePercent( float pct, size_t& cursor ) const { return sample( pct * getLength(), cursor ); }
+	PathSample<T> samplePercent( float pct ) const { return sample( pct * getLength() ); }
+
+	T getPosition( float distance ) const { return sample( distance ).position; }
+	T getTangent( float distance ) const { return sample( distance ).tangent; }
+
+protected:
+	struct Segment
+	{
+		T p0, c1, c2, p1;
+	};
+
+	// appends 'subdivisions' table entries, at even steps of the curve parameter
+	void addSegment( const Segment& segment, int subdivisions )
+	{
+		auto index   = ( uint32_t )m_segments.size();
+		float length = getLength();
+		T prev       = segment.p0;
+		m_segments.push_back( segment );
+
+		m_distances.reserve( m_distances.size() + subdivisions + 1 );
+		m_entrySegments.reserve( m_entrySegments.size() + subdivisions + 1 );
+		m_entryParams.reserve( m_entryParams.size() + subdivisions + 1 );
+		m_entrySpeeds.reserve( m_entrySpeeds.size() + subdivisions + 1 );
+
+		// each segment starts with its own entry, so a table interval never spans two segments
+		for ( int i = 0; i <= subdivisions; ++i ) {
+			float u = float( i ) / subdivisions;
+			T point = evaluate( segment, u );
+			length += glm::length( point - prev );
+			prev = point;
+			m_distances.push_back( length );
+			m_entrySegments.push_back( index );
+			m_entryParams.push_back( u );
+			m_entrySpeeds.push_back( glm::length( derivative( segment, u ) ) );
+		}
+	}
+
+	// within a table interval, distance is a cubic (hermite) of the curve parameter, sloped by the speeds at its ends -
+	// returns the parameter (0-1) at 'pct' of the distance, in a couple of newton steps from linear
+	static float invertDistance( float pct, float slope0, float slope1 )
+	{
+		float x = pct;
+		for ( int i = 0; i < 2; ++i ) {
+			float x2 = x * x;
+			float h  = ( x2 * x - 2.f * x2 + x ) * slope0 + ( -2.f * x2 * x + 3.f * x2 ) + ( x2 * x - x2 ) * slope1;
+			float dh = ( 3.f * x2 - 4.f * x + 1.f ) * slope0 + ( -6.f * x2 + 6.f * x ) + ( 3.f * x2 - 2.f * x ) * slope1;
+			if ( dh <= 0.f )
+				break;
+			x = ga::clamp( x - ( h - pct ) / dh, 0.f, 1.f );
+		}
+		return x;
+	}
+
+	// index i of the table interval with distances[i] <= distance < distances[i + 1] (the last one at the end)
+	size_t findEntry( float distance, size_t cursor ) const
+	{
+		size_t last = m_distances.size() - 2;
+		if ( cursor <= last && m_distances[cursor] <= distance ) {
+			// step forward a few entries, then give up and search
+			for ( int i = 0; i < 4 && cursor <= last; ++i, ++cursor ) {
+				if ( distance < m_distances[cursor + 1] )
+					return cursor;
+			}
+		}
+		auto it = std::upper_bound( m_distances.begin(), m_distances.end(), distance );
+		return std::min( size_t( it - m_distances.begin() ) - 1, last );
+	}
+
+	static T evaluate( const Segment& s, float u )
+	{
+		float v = 1.f - u;
+		return s.p0 * ( v * v * v ) + s.c1 * ( 3.f * v * v * u ) + s.c2 * ( 3.f * v * u * u ) + s.p1 * ( u * u * u );
+	}
+
+	static T derivative( const Segment& s, float u )
+	{
+		float v = 1.f - u;
+		return ( s.c1 - s.p0 ) * ( 3.f * v * v ) + ( s.c2 - s.c1 ) * ( 6.f * v * u ) + ( s.p1 - s.c2 ) * ( 3.f * u * u );
+	}
+
+	T m_start;
+	int m_curveSubdivisions;
+	std::vector<Segment> m_segments;
+
+	// arc length table, as arrays - distance from the start, at a segment's curve parameter, and the speed there
+	std::vector<float> m_distances;
+	std::vector<uint32_t> m_entrySegments;
+	std::vector<float> m_entryParams;
+	std::vector<float> m_entrySpeeds;
+};
+
+/**
+ * @brief PathTween moves along a shared Path at constant speed, shaped by an ease, with the Tween interface -
+ * bind, onDone, and adding to a Timeline. Optionally writes the orientation along the path too.
+ *
+ *		auto tween = std::make_shared<PathTween<vec2>>( path, easeFn( EaseType::EXPO_IN_OUT ) );
+ *		tween->bind( node->getTranslationProperty() ).bindOrientation( node->getRotationProperty() );
+ *		tween->startAtSpeed( 300.f );  // units per second
+ */
+template <typename T, typename Ease = EasingFn>
+class PathTween : public TweenBase, public Timer
+{
+public:
+	friend class Timeline;
+
+	PathTween( std::shared_ptr<const Path<T>> path = nullptr, Ease easeFn = Ease(), Callback onDone = nullptr )
+	    : Timer()
+	    , m_easeFn( easeFn )
+	    , m_onDone( std::move( onDone ) )
+	{
+		setPath( path );
+	}
+
+	PathTween& setPath( std::shared_ptr<const Path<T>> path )
+	{
+		m_path   = path;
+		m_cursor = 0;
+		evaluate( 0.f );
+		return *this;
+	}
+	const std::shared_ptr<const Path<T>>& getPath() const { return m_path; }
+
+	// the part of the path to travel, as percents of its length - 'from' > 'to' travels backwards
+	PathTween& setRange( float fromPct, float toPct )
+	{
+		m_fromPct = ga::clamp( fromPct, 0.f, 1.f );
+		m_toPct   = ga::clamp( toPct, 0.f, 1.f );
+		return *this;
+	}
+
+	// by type - needs the default, std::function Ease
+	template <typename E = Ease, typename = std::enable_if_t<std::is_same<E, EasingFn>::value>>
+	PathTween& setEaseFn( ga::EaseType easeFnType )
+	{
+		m_easeFn = ga::easeFn( easeFnType );
+		return *this;
+	}
+	PathTween& setEaseFn( Ease easeFn )
+	{
+		m_easeFn = easeFn;
+		return *this;
+	}
+
+	// assign callback on done
+	PathTween& setOnDone( Callback onDone )
+	{
+		m_onDone = std::move( onDone );
+		return *this;
+	}
+
+	// bind a ptr to update with the position
+	PathTween& bind( T* ptr )
+	{
+		m_boundPtr = ptr;
+		return *this;
+	}
+	// bind a property (i.e. node->getTranslationProperty()) - safe if its owner is destroyed first
+	PathTween& bind( Property<T> property )
+	{
+		m_boundProperty = property;
+		return *this;
+	}
+	// bind the rotation facing along the path (see getPathOrientation())
+	PathTween& bindOrientation( quat* ptr )
+	{
+		m_boundOrientationPtr = ptr;
+		return *this;
+	}
+	PathTween& bindOrientation( Property<quat> property )
+	{
+		m_boundOrientation = property;
+		return *this;
+	}
+	PathTween& unbind()
+	{
+		m_boundPtr            = nullptr;
+		m_boundOrientationPtr = nullptr;
+		m_boundProperty.reset();
+		m_boundOrientation.reset();
+		return *this;
+	}
+
+	const T& getValue() const { return m_sample.position; }
+	const T& getTangent() const { return m_sample.tangent; }
+	quat getOrientation() const { return getPathOrientation( m_sample.tangent ); }
+
+	// travel the range at 'unitsPerSecond' (on average, when eased)
+	void startAtSpeed( float unitsPerSecond )
+	{
+		float distance = m_path ? std::abs( m_toPct - m_fromPct ) * m_path->getLength() : 0.f;
+		Timer::startNow( unitsPerSecond > 0.f ? long( distance / unitsPerSecond * 1000.f ) : 0 );
+	}
+
+	// update and return current position (call at frame rate when using bound ptr)
+	const T& update()
+	{
+		update_();
+		if ( Timer::isDone() ) {
+			end();
+		}
+		return m_sample.position;
+	}
+
+	// end animation now (optionally firing callback), return end position
+	const T& endNow( bool fireCallback = true )
+	{
+		end( fireCallback );
+		return m_sample.position;
+	}
+
+	// jump to 'pct' (0-1) of the tween, regardless of the timer and without callbacks (i.e. for scrubbing)
+	const T& seek( float pct )
+	{
+		evaluate( ga::clamp( pct, 0.f, 1.f ) );
+		return m_sample.position;
+	}
+
+protected:
+	// one lookup - 'pct' is of the tween, before easing
+	void evaluate( float pct )
+	{
+		if ( !m_path ) {
+			m_sample = { T( 0.f ), T( 0.f ) };
+			return;
+		}
+		if ( pct > 0.f && pct < 1.f )
+			pct = applyEaseFn( m_easeFn, pct );
+		m_sample = m_path->samplePercent( ga::lerp( m_fromPct, m_toPct, pct ), m_cursor );
+		if ( m_toPct < m_fromPct )
+			m_sample.tangent = -m_sample.tangent;
+		updateBoundPtr();
+	}
+
+	void updateBoundPtr()
+	{
+		if ( m_boundPtr )
+			*m_boundPtr = m_sample.position;
+		m_boundProperty.set( m_sample.position );
+		if ( m_boundOrientationPtr || m_boundOrientation.isValid() ) {
+			auto orientation = getOrientation();
+			if ( m_boundOrientationPtr )
+				*m_boundOrientationPtr = orientation;
+			m_boundOrientation.set( orientation );
+		}
+	}
+
+	void end( bool fireCallback = true ) override
+	{
+		evaluate( 1.f );
+		Timer::clear();
+		if ( fireCallback && m_onDone ) {
+			try {
+				m_onDone();
+			} catch ( std::exception& e ) {
+				// todo: log exception
+				m_onDone = nullptr;  // clear callback since it's broken
+			}
+		}
+	}
+
+	bool update_() override
+	{
+		if ( !m_path || !Timer::isSet() )
+			return false;
+		if ( Timer::isActive() ) {
+			evaluate( float( Timer::elapsedPercent() ) );
+		} else if ( Timer::isDone() ) {
+			evaluate( 1.f );
+		}
+		return !Timer::isDone();
+	}
+
+	bool isDone_() override { return Timer::isDone(); }
+	bool isStarted_() override { return Timer::isStarted(); }
+	void seek_( float pct ) override { seek( pct ); }
+
+	std::shared_ptr<const Path<T>> m_path;
+	size_t m_cursor = 0;
+	float m_fromPct = 0.f;
+	float m_toPct   = 1.f;
+	PathSample<T> m_sample;
+	Ease m_easeFn;
+	Callback m_onDone;
+
+	T* m_boundPtr               = nullptr;
+	quat* m_boundOrientationPtr = nullptr;
+	Property<T> m_boundProperty;
+	Property<quat> m_boundOrientation;
+};
+
+}  // namespace ga
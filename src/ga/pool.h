@@ -0,0 +1,127 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace ga {
+
+/**
+ * @brief BlockPool hands out fixed size blocks, recycled through a free list - so objects created and destroyed
+ * at animation rates (i.e. fire-and-forget tweens) stop allocating once the pool has grown to the peak count.
+ *
+ * Grows a chunk of blocks at a time, and never shrinks. Not thread-safe - pools are for the update thread.
+ */
+class BlockPool
+{
+public:
+	BlockPool( size_t blockSize, size_t blocksPerChunk = 64 )
+	    : m_blockSize( roundUp( std::max( blockSize, sizeof( void* ) ), alignof( std::max_align_t ) ) )
+	    , m_blocksPerChunk( std::max( blocksPerChunk, size_t( 1 ) ) )
+	{
+	}
+	~BlockPool()
+	{
+		for ( auto chunk : m_chunks ) {
+			::operator delete( chunk );
+		}
+	}
+
+	BlockPool( const BlockPool& ) = delete;
+	BlockPool& operator=( const BlockPool& ) = delete;
+
+	void* allocate()
+	{
+		if ( !m_free )
+			grow();
+		void* block = m_free;
+		m_free      = *static_cast<void**>( block );
+		++m_numUsed;
+		return block;
+	}
+
+	void deallocate( void* block )
+	{
+		if ( !block )
+			return;
+		*static_cast<void**>( block ) = m_free;
+		m_free                        = block;
+		--m_numUsed;
+	}
+
+	size_t getBlockSize() const { return m_blockSize; }
+	size_t getNumUsed() const { return m_numUsed; }
+	size_t getCapacity() const { return m_chunks.size() * m_blocksPerChunk; }
+
+protected:
+	static size_t roundUp( size_t size, size_t align ) { return ( size + align - 1 ) / align * align; }
+
+	void grow()
+	{
+		auto chunk = static_cast<char*>( ::operator new( m_blockSize * m_blocksPerChunk ) );
+		m_chunks.push_back( chunk );
+		// thread the new blocks onto the free list, first block first
+		for ( size_t i = m_blocksPerChunk; i-- > 0; ) {
+			void* block                   = chunk + i * m_blockSize;
+			*static_cast<void**>( block ) = m_free;
+			m_free                        = block;
+		}
+	}
+
+	size_t m_blockSize;
+	size_t m_blocksPerChunk;
+	std::vector<void*> m_chunks;
+	void* m_free     = nullptr;
+	size_t m_numUsed = 0;
+};
+
+// shared by every type of the same size and alignment
+// (never destroyed - so objects released during static destruction still have a pool to return to)
+template <size_t Size, size_t Align>
+inline BlockPool& getBlockPool()
+{
+	static_assert( Align <= alignof( std::max_align_t ), "over-aligned types aren't pooled" );
+	static auto pool = new BlockPool( Size );
+	return *pool;
+}
+
+/**
+ * @brief PoolAllocator is a std allocator that takes single objects from a BlockPool - i.e. for
+ * std::allocate_shared(), or the nodes of a std::map. Arrays go to the heap as usual.
+ *
+ *		auto tween = std::allocate_shared<Tween<float>>( PoolAllocator<Tween<float>>(), 0.f, 1.f );
+ */
+template <typename T>
+class PoolAllocator
+{
+public:
+	using value_type = T;
+
+	PoolAllocator() = default;
+	template <typename U>
+	PoolAllocator( const PoolAllocator<U>& )
+	{
+	}
+
+	T* allocate( size_t n )
+	{
+		if ( n == 1 )
+			return static_cast<T*>( getBlockPool<sizeof( T ), alignof( T )>().allocate() );
+		return static_cast<T*>( ::operator new( n * sizeof( T ) ) );
+	}
+
+	void deallocate( T* ptr, size_t n )
+	{
+		if ( n == 1 )
+			getBlockPool<sizeof( T ), alignof( T )>().deallocate( ptr );
+		else
+			::operator delete( ptr );
+	}
+
+	template <typename U>
+	bool operator==( const PoolAllocator<U>& ) const { return true; }
+	template <typename U>
+	bool operator!=( const PoolAllocator<U>& ) const { return false; }
+};
+
+}  // namespace ga
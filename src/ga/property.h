@@ -0,0 +1,69 @@
+#pragma once
+#include <memory>
+
+namespace ga {
+
+/**
+ * @brief Property is a typed handle to a value owned by a shared object - i.e. a Node's translation,
+ * or a Component's field - for tweens to write to.
+ *
+ * Unlike a raw pointer, it holds a weak reference to its owner, so writes are skipped once the owner
+ * is destroyed. Writes go through a plain function pointer (i.e. Transform::setTranslation, so caches
+ * are invalidated), with no std::function or allocation.
+ *
+ *		tween->bind( node->getTranslationProperty() );
+ *		tween->bind( Property<Color>::field( tint, &Tint::color ) );
+ */
+template <typename T>
+class Property
+{
+public:
+	using Setter = void ( * )( void* target, const T& value );
+	using Getter = T ( * )( const void* target );
+
+	Property() = default;
+	Property( std::weak_ptr<void> owner, void* target, Setter setter, Getter getter )
+	    : m_owner( owner )
+	    , m_target( target )
+	    , m_setter( setter )
+	    , m_getter( getter )
+	{
+	}
+
+	// a plain field of a shared object, i.e. Property<Color>::field( tint, &Tint::color )
+	template <typename Owner>
+	static Property field( const std::shared_ptr<Owner>& owner, T Owner::*member )
+	{
+		if ( !owner )
+			return Property();
+		return Property( owner, &( owner.get()->*member ),
+		                 []( void* target, const T& value ) { *static_cast<T*>( target ) = value; },
+		                 []( const void* target ) { return *static_cast<const T*>( target ); } );
+	}
+
+	// false once the owner is destroyed (or if never set)
+	bool isValid() const { return m_target && !m_owner.expired(); }
+	explicit operator bool() const { return isValid(); }
+
+	// returns false, without writing, if the owner is gone
+	bool set( const T& value ) const
+	{
+		if ( !isValid() )
+			return false;
+		m_setter( m_target, value );
+		return true;
+	}
+
+	// T() if the owner is gone
+	T get() const { return isValid() ? m_getter( m_target ) : T(); }
+
+	void reset() { *this = Property(); }
+
+protected:
+	std::weak_ptr<void> m_owner;
+	void* m_target  = nullptr;
+	Setter m_setter = nullptr;
+	Getter m_getter = nullptr;
+};
+
+}  // namespace ga
@@ -116,6 +116,21 @@ void Renderer::scale( const vec3& scale )
 	multMatrix( glm::scale( mat4( 1. ), scale ) );
 }
 
+Ray Renderer::windowPosToRay( const vec2& windowPos )
+{
+	// window -> normalized device coords (y up)
+	vec2 ndc( 2.f * ( windowPos.x - m_viewport.x ) / m_viewport.w - 1.f,
+	          1.f - 2.f * ( windowPos.y - m_viewport.y ) / m_viewport.h );
+
+	// unproject points on the near and far planes
+	mat4 inv = glm::inverse( m_matrices[MatrixType::PROJECTION] * m_matrices[MatrixType::VIEW] );
+	vec4 a   = inv * vec4( ndc, -1.f, 1.f );
+	vec4 b   = inv * vec4( ndc, 1.f, 1.f );
+	vec3 pA  = vec3( a ) / a.w;
+	vec3 pB  = vec3( b ) / b.w;
+	return Ray { pA, glm::normalize( pB - pA ) };
+}
+
 void Renderer::setGlobalColor( const Color& color )
 {
 	m_globalColor = color;
@@ -30,6 +30,13 @@ public:
 	void rotate( const quat& rotation );
 	void scale( const vec3& scale );
 
+	// viewport (window space, origin at top left) - used to convert window positions to rays
+	void setViewport( const Rect& viewport ) { m_viewport = viewport; }
+	const Rect& getViewport() const { return m_viewport; }
+
+	// scene space ray through a window position, from the VIEW and PROJECTION matrices and viewport
+	Ray windowPosToRay( const vec2& windowPos );
+
 	// color / style management
 	void setGlobalColor( const ga::Color& color );
 	const ga::Color& getGlobalColor();
@@ -44,6 +51,7 @@ protected:
 	    { MatrixType::PROJECTION, ga::mat4( 1.f ) } };
 	std::map<MatrixType, std::vector<ga::mat4>> m_matrixStack;
 	Color m_globalColor { 1.f, 1.f, 1.f, 1.f };
+	Rect m_viewport { 0.f, 0.f, 0.f, 0.f };
 };
 
 // singleton
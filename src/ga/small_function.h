@@ -0,0 +1,182 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ga {
+
+// false for null function pointers and empty std::functions - so they convert to an empty SmallFunction
+template <typename F>
+inline bool isEmptyCallable( const F& ) { return false; }
+template <typename R, typename... Args>
+inline bool isEmptyCallable( R ( *fn )( Args... ) ) { return fn == nullptr; }
+template <typename Sig>
+inline bool isEmptyCallable( const std::function<Sig>& fn ) { return !fn; }
+
+template <typename Signature, size_t Capacity = 48>
+class SmallFunction;
+
+/**
+ * @brief SmallFunction is a std::function that stores callables of up to 'Capacity' bytes inline, instead of on the heap -
+ * i.e. a lambda capturing a few pointers, or a std::function. Larger callables still work, with one allocation.
+ *
+ * Used for callbacks that are created and dropped at animation rates (tween onDone and update callbacks).
+ */
+template <typename R, typename... Args, size_t Capacity>
+class SmallFunction<R( Args... ), Capacity>
+{
+public:
+	SmallFunction() = default;
+	SmallFunction( std::nullptr_t ) {}
+
+	template <typename F, typename Fn = typename std::decay<F>::type,
+	          typename = typename std::enable_if<!std::is_same<Fn, SmallFunction>::value && !std::is_same<Fn, std::nullptr_t>::value>::type>
+	SmallFunction( F&& fn )
+	{
+		if ( isEmptyCallable( fn ) )
+			return;
+		if ( isInline<Fn>() )
+			new ( &m_storage ) Fn( std::forward<F>( fn ) );
+		else
+			new ( &m_storage ) Fn*( new Fn( std::forward<F>( fn ) ) );
+		m_ops = &s_ops<Fn>;
+	}
+
+	SmallFunction( const SmallFunction& other )
+	{
+		if ( other.m_ops ) {
+			other.m_ops->copy( &other.m_storage, &m_storage );
+			m_ops = other.m_ops;
+		}
+	}
+	SmallFunction( SmallFunction&& other ) noexcept
+	{
+		if ( other.m_ops ) {
+			other.m_ops->move( &other.m_storage, &m_storage );
+			m_ops       = other.m_ops;
+			other.m_ops = nullptr;
+		}
+	}
+	~SmallFunction() { reset(); }
+
+	SmallFunction& operator=( const SmallFunction& other )
+	{
+		if ( this != &other )
+			*this = SmallFunction( other );
+		return *this;
+	}
+	SmallFunction& operator=( SmallFunction&& other ) noexcept
+	{
+		if ( this != &other ) {
+			reset();
+			if ( other.m_ops ) {
+				other.m_ops->move( &other.m_storage, &m_storage );
+				m_ops       = other.m_ops;
+				other.m_ops = nullptr;
+			}
+		}
+		return *this;
+	}
+	SmallFunction& operator=( std::nullptr_t )
+	{
+		reset();
+		return *this;
+	}
+
+	explicit operator bool() const { return m_ops != nullptr; }
+
+	// throws std::bad_function_call if empty, like std::function
+	R operator()( Args... args ) const
+	{
+		if ( !m_ops )
+			throw std::bad_function_call();
+		return m_ops->invoke( const_cast<Storage*>( &m_storage ), std::forward<Args>( args )... );
+	}
+
+	void reset()
+	{
+		if ( m_ops ) {
+			m_ops->destroy( &m_storage );
+			m_ops = nullptr;
+		}
+	}
+
+	// true if a callable of type F is stored without allocating
+	template <typename F>
+	static constexpr bool isInline()
+	{
+		return sizeof( F ) <= Capacity && alignof( F ) <= alignof( std::max_align_t ) && std::is_nothrow_move_constructible<F>::value;
+	}
+
+protected:
+	using Storage = typename std::aligned_storage<Capacity, alignof( std::max_align_t )>::type;
+
+	// per callable type
+	struct Ops
+	{
+		R ( *invoke )( void* storage, Args&&... args );
+		void ( *copy )( const void* from, void* to );
+		void ( *move )( void* from, void* to );  // and destroys 'from'
+		void ( *destroy )( void* storage );
+	};
+
+	template <typename Fn>
+	static Fn& get( void* storage )
+	{
+		return isInline<Fn>() ? *static_cast<Fn*>( storage ) : **static_cast<Fn**>( storage );
+	}
+
+	template <typename Fn>
+	static R invoke( void* storage, Args&&... args )
+	{
+		return get<Fn>( storage )( std::forward<Args>( args )... );
+	}
+
+	template <typename Fn>
+	static void copy( const void* from, void* to )
+	{
+		auto& fn = get<Fn>( const_cast<void*>( from ) );
+		if ( isInline<Fn>() )
+			new ( to ) Fn( fn );
+		else
+			new ( to ) Fn*( new Fn( fn ) );
+	}
+
+	template <typename Fn>
+	static void move( void* from, void* to )
+	{
+		if ( isInline<Fn>() ) {
+			new ( to ) Fn( std::move( get<Fn>( from ) ) );
+			get<Fn>( from ).~Fn();
+		} else {
+			new ( to ) Fn*( *static_cast<Fn**>( from ) );  // just the pointer
+		}
+	}
+
+	template <typename Fn>
+	static void destroy( void* storage )
+	{
+		if ( isInline<Fn>() )
+			get<Fn>( storage ).~Fn();
+		else
+			delete *static_cast<Fn**>( storage );
+	}
+
+	template <typename Fn>
+	static const Ops s_ops;
+
+	Storage m_storage;
+	const Ops* m_ops = nullptr;
+};
+
+template <typename R, typename... Args, size_t Capacity>
+template <typename Fn>
+const typename SmallFunction<R( Args... ), Capacity>::Ops SmallFunction<R( Args... ), Capacity>::s_ops = {
+	&SmallFunction::invoke<Fn>, &SmallFunction::copy<Fn>, &SmallFunction::move<Fn>, &SmallFunction::destroy<Fn> };
+
+// a callback with no arguments, i.e. onDone
+using Callback = SmallFunction<void()>;
+
+}  // namespace ga
@@ -0,0 +1,120 @@
+#pragma once
+#include "ga/math.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace ga {
+
+/**
+ * @brief SpatialGrid is a 2D uniform grid of boxes (xy only), for fast point queries.
+ *
+ * Items are identified by their index in the vector passed to build().
+ * Storage is reused between builds, so rebuilding every frame does not allocate once warmed up.
+ */
+class SpatialGrid
+{
+public:
+	// rebuild the grid - empty boxes are skipped
+	void build( const std::vector<Bounds3D>& boxes )
+	{
+		m_boxes = boxes;
+		m_cellStart.clear();
+		m_items.clear();
+
+		// grid extents
+		Bounds3D extents = Bounds3D::empty();
+		size_t count     = 0;
+		for ( auto& box : m_boxes ) {
+			if ( !box.isEmpty() ) {
+				extents.include( box );
+				++count;
+			}
+		}
+		if ( !count ) {
+			m_cols = m_rows = 0;
+			return;
+		}
+
+		// aim for roughly one item per cell
+		vec2 size     = glm::max( vec2( extents.size() ), vec2( 1.f ) );
+		m_cols        = ga::clamp( ( int )std::ceil( std::sqrt( count * size.x / size.y ) ), 1, s_maxCells );
+		m_rows        = ga::clamp( ( int )std::ceil( ( float )count / m_cols ), 1, s_maxCells );
+		m_origin      = vec2( extents.min );
+		m_cellSize    = size / vec2( ( float )m_cols, ( float )m_rows );
+		size_t nCells = ( size_t )m_cols * m_rows;
+
+		// counting sort items into cells: count, prefix sum, fill
+		m_cellStart.assign( nCells + 1, 0 );
+		forEachCell( [this]( uint32_t, size_t cell ) { ++m_cellStart[cell + 1]; } );
+		for ( size_t i = 1; i <= nCells; ++i ) {
+			m_cellStart[i] += m_cellStart[i - 1];
+		}
+		m_items.resize( m_cellStart.back() );
+		m_cursor.assign( m_cellStart.begin(), m_cellStart.end() - 1 );
+		forEachCell( [this]( uint32_t item, size_t cell ) { m_items[m_cursor[cell]++] = item; } );
+	}
+
+	// append the items whose box contains pt (in xy)
+	void query( const vec2& pt, std::vector<uint32_t>& items ) const
+	{
+		if ( !m_cols || !m_rows )
+			return;
+		int col = ( int )std::floor( ( pt.x - m_origin.x ) / m_cellSize.x );
+		int row = ( int )std::floor( ( pt.y - m_origin.y ) / m_cellSize.y );
+		if ( col < 0 || row < 0 || col >= m_cols || row >= m_rows )
+			return;
+		size_t cell = ( size_t )row * m_cols + col;
+		for ( uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i ) {
+			auto item = m_items[i];
+			auto& box = m_boxes[item];
+			if ( pt.x >= box.min.x && pt.y >= box.min.y && pt.x <= box.max.x && pt.y <= box.max.y )
+				items.push_back( item );
+		}
+	}
+
+	void clear()
+	{
+		m_boxes.clear();
+		m_cellStart.clear();
+		m_items.clear();
+		m_cols = m_rows = 0;
+	}
+
+protected:
+	static constexpr int s_maxCells = 256;  // per axis (defined in scene.cpp)
+
+	// call fn( item, cell ) for every cell overlapped by every item
+	template <typename Fn>
+	void forEachCell( Fn fn )
+	{
+		for ( uint32_t item = 0; item < m_boxes.size(); ++item ) {
+			auto& box = m_boxes[item];
+			if ( box.isEmpty() )
+				continue;
+			int c0 = cellCoord( box.min.x, m_origin.x, m_cellSize.x, m_cols );
+			int c1 = cellCoord( box.max.x, m_origin.x, m_cellSize.x, m_cols );
+			int r0 = cellCoord( box.min.y, m_origin.y, m_cellSize.y, m_rows );
+			int r1 = cellCoord( box.max.y, m_origin.y, m_cellSize.y, m_rows );
+			for ( int r = r0; r <= r1; ++r ) {
+				for ( int c = c0; c <= c1; ++c ) {
+					fn( item, ( size_t )r * m_cols + c );
+				}
+			}
+		}
+	}
+
+	static int cellCoord( float v, float origin, float cellSize, int count )
+	{
+		return ga::clamp( ( int )std::floor( ( v - origin ) / cellSize ), 0, count - 1 );
+	}
+
+	std::vector<Bounds3D> m_boxes;
+	std::vector<uint32_t> m_cellStart;  // per cell offset into m_items (+1 end marker)
+	std::vector<uint32_t> m_items;      // item indices, grouped by cell
+	std::vector<uint32_t> m_cursor;     // build scratch
+	vec2 m_origin, m_cellSize;
+	int m_cols = 0, m_rows = 0;
+};
+
+}  // namespace ga
@@ -0,0 +1,632 @@
+#pragma once
+#include "ga/math.h"
+#include "ga/property.h"
+#include "ga/small_function.h"
+#include "ga/timer.h"
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace ga {
+
+// identifies a spring in a SpringEngine - stays unique after the spring is removed, 0 is never valid
+using SpringId = uint64_t;
+
+/**
+ * @brief SpringEngine integrates many damped springs per frame, stored as structure-of-arrays.
+ *
+ * Unlike a Tween, a spring has no duration: it chases its target, keeping its velocity when
+ * the target moves - so it can be retargeted every frame (i.e. while dragging), without allocation.
+ *
+ * Each value type (float, vec2, vec3, vec4) has its own track of arrays. Awake springs are kept packed
+ * at the front of their track, and integrated in one flat pass per substep. A spring that comes
+ * to rest snaps to its target and goes to sleep, until it's retargeted or nudged.
+ */
+class SpringEngine
+{
+public:
+	// damping for the fastest motion without overshoot, at 'stiffness'
+	static float criticalDamping( float stiffness ) { return 2.f * std::sqrt( stiffness ); }
+
+	// add a spring at 'value', heading to 'target' - the bound value (if any) is written every update while it moves
+	template <typename T>
+	SpringId add( const T& value, const T& target, float stiffness = 170.f, float damping = criticalDamping( 170.f ), T* bound = nullptr );
+
+	bool remove( SpringId id );
+	bool isActive( SpringId id ) const;  // still in the engine (awake or sleeping)
+	bool isSleeping( SpringId id ) const;
+
+	// setting the target, value or velocity wakes the spring
+	template <typename T>
+	bool setTarget( SpringId id, const T& target );
+	template <typename T>
+	bool setValue( SpringId id, const T& value, const T& velocity = T( 0.f ) );
+	template <typename T>
+	bool setVelocity( SpringId id, const T& velocity );  // i.e. the fling speed at the end of a drag
+
+	bool setStiffness( SpringId id, float stiffness, float damping );
+
+	template <typename T>
+	const T* getValue( SpringId id ) const;
+	template <typename T>
+	const T* getVelocity( SpringId id ) const;
+	template <typename T>
+	const T* getTarget( SpringId id ) const;
+
+	template <typename T>
+	bool bind( SpringId id, T* ptr );
+	template <typename T>
+	bool bind( SpringId id, Property<T> property );  // skipped once its owner is destroyed
+
+	// called when the spring comes to rest (and sleeps)
+	bool setOnRest( SpringId id, Callback onRest );
+
+	// integrate every awake spring - called by Scene::update(), only once per clock time
+	void update();
+
+	// a spring sleeps once it's within 'distance' of its target, and slower than 'speed' (units per second)
+	void setRestThreshold( float distance, float speed )
+	{
+		m_restDistance = distance;
+		m_restSpeed    = speed;
+	}
+
+	// the longest integration step - longer frames are split into substeps, for stability
+	void setMaxStep( double seconds ) { m_maxStep = seconds > 0. ? seconds : m_maxStep; }
+
+	size_t size() const { return m_slots.size() - m_freeSlots.size(); }
+	size_t getNumAwake() const;
+	void clear();
+
+	// the clock springs are timed with - getFrameClock() by default, nullptr for Clock::now()
+	void setClock( FrameClock* clock ) { m_clock = clock; }
+	FrameClock* getClock() const { return m_clock; }
+
+protected:
+	template <typename T>
+	struct Track
+	{
+		std::vector<T> value, velocity, target;
+		std::vector<float> stiffness, damping;
+		std::vector<T*> bound;
+		std::vector<Property<T>> property;
+		std::vector<uint32_t> slots;  // owning slot, for swapping
+		size_t awake = 0;             // springs [0, awake) are integrated
+
+		void swapEntries( size_t a, size_t b )
+		{
+			std::swap( value[a], value[b] );
+			std::swap( velocity[a], velocity[b] );
+			std::swap( target[a], target[b] );
+			std::swap( stiffness[a], stiffness[b] );
+			std::swap( damping[a], damping[b] );
+			std::swap( bound[a], bound[b] );
+			std::swap( property[a], property[b] );
+			std::swap( slots[a], slots[b] );
+		}
+
+		void popBack()
+		{
+			value.pop_back();
+			velocity.pop_back();
+			target.pop_back();
+			stiffness.pop_back();
+			damping.pop_back();
+			bound.pop_back();
+			property.pop_back();
+			slots.pop_back();
+		}
+	};
+
+	using Tracks = std::tuple<Track<float>, Track<vec2>, Track<vec3>, Track<vec4>>;
+
+	struct Slot
+	{
+		uint32_t type       = 0;  // index into Tracks
+		uint32_t index      = 0;  // into the track's arrays
+		uint32_t generation = 1;
+		bool isUsed         = false;
+		Callback onRest;
+	};
+
+	template <typename T>
+	Track<T>& track() { return std::get<Track<T>>( m_tracks ); }
+	template <typename T>
+	const Track<T>& track() const { return std::get<Track<T>>( m_tracks ); }
+
+	template <typename T>
+	static constexpr uint32_t typeIndex();
+
+	// squared length, for the rest test
+	static float length2( float v ) { return v * v; }
+	template <typename T>
+	static float length2( const T& v ) { return glm::dot( v, v ); }
+
+	template <typename T>
+	void integrateTrack( Track<T>& track, float dt, int steps );
+
+	template <typename T>
+	void swapInTrack( Track<T>& track, size_t a, size_t b );
+	template <typename T>
+	void wake( uint32_t slotIndex );
+	template <typename T>
+	void removeFromTrack( uint32_t slotIndex );
+
+	template <typename T>
+	Track<T>* findTrack( SpringId id, size_t& index );
+	template <typename T>
+	const Track<T>* findTrack( SpringId id, size_t& index ) const;
+
+	const Slot* findSlot( SpringId id ) const;
+	uint32_t allocSlot();
+	void freeSlot( uint32_t index );
+
+	static SpringId makeId( uint32_t index, uint32_t generation ) { return ( ( SpringId )generation << 32 ) | ( index + 1 ); }
+	static uint32_t slotIndex( SpringId id ) { return ( uint32_t )( id & 0xffffffff ) - 1; }
+
+	Tracks m_tracks;
+	std::vector<Slot> m_slots;
+	std::vector<uint32_t> m_freeSlots;
+	std::vector<uint32_t> m_rested;     // slots that came to rest this update (scratch)
+	std::vector<Callback> m_callbacks;  // their onRest callbacks (scratch)
+	float m_restDistance = 1e-3f;
+	float m_restSpeed    = 1e-3f;
+	double m_maxStep     = 1. / 240.;
+	FrameClock* m_clock  = &getFrameClock();
+	TimePoint m_lastUpdate;
+};
+
+// singleton, updated by Scene::update()
+inline SpringEngine& getSpringEngine()
+{
+	static SpringEngine e;
+	return e;
+}
+
+/**
+ * @brief Spring is a handle to a spring in a SpringEngine, which it removes on destruction.
+ *
+ *		Spring<vec3> snap( node->getTranslation() );
+ *		snap.bind( node->getTranslationProperty() );
+ *		snap.setTarget( dragPosition );  // every touch frame
+ */
+template <typename T>
+class Spring
+{
+public:
+	Spring( const T& value = T( 0.f ), float stiffness = 170.f, float damping = SpringEngine::criticalDamping( 170.f ),
+	        SpringEngine& engine = getSpringEngine() )
+	    : m_engine( &engine )
+	{
+		m_id = m_engine->add( value, value, stiffness, damping );
+	}
+	~Spring()
+	{
+		if ( m_engine )
+			m_engine->remove( m_id );
+	}
+
+	Spring( const Spring& ) = delete;
+	Spring& operator=( const Spring& ) = delete;
+	Spring( Spring&& other ) { *this = std::move( other ); }
+	Spring& operator=( Spring&& other )
+	{
+		if ( this != &other ) {
+			if ( m_engine )
+				m_engine->remove( m_id );
+			m_engine       = other.m_engine;
+			m_id           = other.m_id;
+			other.m_engine = nullptr;
+			other.m_id     = 0;
+		}
+		return *this;
+	}
+
+	Spring& setTarget( const T& target )
+	{
+		m_engine->setTarget( m_id, target );
+		return *this;
+	}
+	Spring& setValue( const T& value, const T& velocity = T( 0.f ) )
+	{
+		m_engine->setValue( m_id, value, velocity );
+		return *this;
+	}
+	Spring& setVelocity( const T& velocity )
+	{
+		m_engine->setVelocity( m_id, velocity );
+		return *this;
+	}
+	Spring& setStiffness( float stiffness, float damping )
+	{
+		m_engine->setStiffness( m_id, stiffness, damping );
+		return *this;
+	}
+	Spring& setOnRest( Callback onRest )
+	{
+		m_engine->setOnRest( m_id, std::move( onRest ) );
+		return *this;
+	}
+	Spring& bind( T* ptr )
+	{
+		m_engine->bind( m_id, ptr );
+		return *this;
+	}
+	Spring& bind( Property<T> property )
+	{
+		m_engine->bind( m_id, property );
+		return *this;
+	}
+
+	const T& getValue() const { return *m_engine->getValue<T>( m_id ); }
+	const T& getVelocity() const { return *m_engine->getVelocity<T>( m_id ); }
+	const T& getTarget() const { return *m_engine->getTarget<T>( m_id ); }
+	bool isSleeping() const { return m_engine->isSleeping( m_id ); }
+
+	SpringId getId() const { return m_id; }
+
+protected:
+	SpringEngine* m_engine = nullptr;
+	SpringId m_id          = 0;
+};
+
+// template implementations
+// ------------------------
+
+template <>
+constexpr uint32_t SpringEngine::typeIndex<float>() { return 0; }
+template <>
+constexpr uint32_t SpringEngine::typeIndex<vec2>() { return 1; }
+template <>
+constexpr uint32_t SpringEngine::typeIndex<vec3>() { return 2; }
+template <>
+constexpr uint32_t SpringEngine::typeIndex<vec4>() { return 3; }
+
+template <typename T>
+SpringId SpringEngine::add( const T& value, const T& target, float stiffness, float damping, T* bound )
+{
+	auto index = allocSlot();
+	auto& t    = track<T>();
+	auto& slot = m_slots[index];
+	slot.type  = typeIndex<T>();
+	slot.index = ( uint32_t )t.slots.size();
+
+	t.value.push_back( value );
+	t.velocity.push_back( T( 0.f ) );
+	t.target.push_back( target );
+	t.stiffness.push_back( stiffness );
+	t.damping.push_back( damping );
+	t.bound.push_back( bound );
+	t.property.emplace_back();
+	t.slots.push_back( index );
+	wake<T>( index );
+	return makeId( index, slot.generation );
+}
+
+template <typename T>
+SpringEngine::Track<T>* SpringEngine::findTrack( SpringId id, size_t& index )
+{
+	auto slot = findSlot( id );
+	if ( !slot || slot->type != typeIndex<T>() )
+		return nullptr;
+	index = slot->index;
+	return &track<T>();
+}
+
+template <typename T>
+const SpringEngine::Track<T>* SpringEngine::findTrack( SpringId id, size_t& index ) const
+{
+	auto slot = findSlot( id );
+	if ( !slot || slot->type != typeIndex<T>() )
+		return nullptr;
+	index = slot->index;
+	return &track<T>();
+}
+
+template <typename T>
+bool SpringEngine::setTarget( SpringId id, const T& target )
+{
+	size_t i;
+	auto t = findTrack<T>( id, i );
+	if ( !t )
+		return false;
+	t->target[i] = target;
+	wake<T>( slotIndex( id ) );
+	return true;
+}
+
+template <typename T>
+bool SpringEngine::setValue( SpringId id, const T& value, const T& velocity )
+{
+	size_t i;
+	auto t = findTrack<T>( id, i );
+	if ( !t )
+		return false;
+	t->value[i]    = value;
+	t->velocity[i] = velocity;
+	wake<T>( slotIndex( id ) );
+	return true;
+}
+
+template <typename T>
+bool SpringEngine::setVelocity( SpringId id, const T& velocity )
+{
+	size_t i;
+	auto t = findTrack<T>( id, i );
+	if ( !t )
+		return false;
+	t->velocity[i] = velocity;
+	wake<T>( slotIndex( id ) );
+	return true;
+}
+
+template <typename T>
+const T* SpringEngine::getValue( SpringId id ) const
+{
+	size_t i;
+	auto t = findTrack<T>( id, i );
+	return t ? &t->value[i] : nullptr;
+}
+
+template <typename T>
+const T* SpringEngine::getVelocity( SpringId id ) const
+{
+	size_t i;
+	auto t = findTrack<T>( id, i );
+	return t ? &t->velocity[i] : nullptr;
+}
+
+template <typename T>
+const T* SpringEngine::getTarget( SpringId id ) const
+{
+	size_t i;
+	auto t = findTrack<T>( id, i );
+	return t ? &t->target[i] : nullptr;
+}
+
+template <typename T>
+bool SpringEngine::bind( SpringId id, T* ptr )
+{
+	size_t i;
+	auto t = findTrack<T>( id, i );
+	if ( !t )
+		return false;
+	t->bound[i] = ptr;
+	return true;
+}
+
+template <typename T>
+bool SpringEngine::bind( SpringId id, Property<T> property )
+{
+	size_t i;
+	auto t = findTrack<T>( id, i );
+	if ( !t )
+		return false;
+	t->property[i] = std::move( property );
+	return true;
+}
+
+template <typename T>
+void SpringEngine::integrateTrack( Track<T>& t, float dt, int steps )
+{
+	size_t n = t.awake;
+	if ( !n )
+		return;
+
+	// semi-implicit euler (unit mass), in flat passes
+	T* value        = t.value.data();
+	T* velocity     = t.velocity.data();
+	const T* target = t.target.data();
+	const float* k  = t.stiffness.data();
+	const float* c  = t.damping.data();
+	for ( int step = 0; step < steps; ++step ) {
+		for ( size_t i = 0; i < n; ++i ) {
+			velocity[i] += ( ( target[i] - value[i] ) * k[i] - velocity[i] * c[i] ) * dt;
+			value[i] += velocity[i] * dt;
+		}
+	}
+
+	// springs at rest snap to their target, and sleep
+	float restDistance2 = m_restDistance * m_restDistance;
+	float restSpeed2    = m_restSpeed * m_restSpeed;
+	for ( size_t i = n; i-- > 0; ) {
+		if ( length2( target[i] - value[i] ) < restDistance2 && length2( velocity[i] ) < restSpeed2 ) {
+			value[i]    = target[i];
+			velocity[i] = T( 0.f );
+			if ( t.bound[i] )
+				*t.bound[i] = value[i];
+			t.property[i].set( value[i] );
+			m_rested.push_back( t.slots[i] );
+			swapInTrack( t, i, --t.awake );
+		}
+	}
+
+	// write bound values
+	for ( size_t i = 0; i < t.awake; ++i ) {
+		if ( t.bound[i] )
+			*t.bound[i] = value[i];
+		t.property[i].set( value[i] );
+	}
+}
+
+template <typename T>
+void SpringEngine::swapInTrack( Track<T>& t, size_t a, size_t b )
+{
+	if ( a == b )
+		return;
+	t.swapEntries( a, b );
+	m_slots[t.slots[a]].index = ( uint32_t )a;
+	m_slots[t.slots[b]].index = ( uint32_t )b;
+}
+
+template <typename T>
+void SpringEngine::wake( uint32_t slotIndex )
+{
+	auto& t    = track<T>();
+	auto index = m_slots[slotIndex].index;
+	if ( index >= t.awake ) {
+		swapInTrack( t, index, t.awake );
+		++t.awake;
+	}
+}
+
+template <typename T>
+void SpringEngine::removeFromTrack( uint32_t slotIndex )
+{
+	auto& t      = track<T>();
+	size_t index = m_slots[slotIndex].index;
+	if ( index < t.awake ) {
+		// keep the awake springs packed
+		swapInTrack( t, index, --t.awake );
+		index = t.awake;
+	}
+	swapInTrack( t, index, t.slots.size() - 1 );
+	t.popBack();
+}
+
+// ---------------------------------------------
+// non-template implementations
+
+inline const SpringEngine::Slot* SpringEngine::findSlot( SpringId id ) const
+{
+	auto index = slotIndex( id );
+	if ( !id || index >= m_slots.size() )
+		return nullptr;
+	auto& slot = m_slots[index];
+	return slot.isUsed && slot.generation == ( uint32_t )( id >> 32 ) ? &slot : nullptr;
+}
+
+inline bool SpringEngine::isActive( SpringId id ) const
+{
+	return findSlot( id ) != nullptr;
+}
+
+inline bool SpringEngine::isSleeping( SpringId id ) const
+{
+	auto slot = findSlot( id );
+	if ( !slot )
+		return false;
+	switch ( slot->type ) {
+		case 0: return slot->index >= track<float>().awake;
+		case 1: return slot->index >= track<vec2>().awake;
+		case 2: return slot->index >= track<vec3>().awake;
+		case 3: return slot->index >= track<vec4>().awake;
+	}
+	return false;
+}
+
+inline bool SpringEngine::setStiffness( SpringId id, float stiffness, float damping )
+{
+	auto slot = findSlot( id );
+	if ( !slot )
+		return false;
+	auto set = [&]( auto& t ) {
+		t.stiffness[slot->index] = stiffness;
+		t.damping[slot->index]   = damping;
+	};
+	switch ( slot->type ) {
+		case 0: set( track<float>() ); break;
+		case 1: set( track<vec2>() ); break;
+		case 2: set( track<vec3>() ); break;
+		case 3: set( track<vec4>() ); break;
+	}
+	return true;
+}
+
+inline bool SpringEngine::setOnRest( SpringId id, Callback onRest )
+{
+	if ( !findSlot( id ) )
+		return false;
+	m_slots[slotIndex( id )].onRest = std::move( onRest );
+	return true;
+}
+
+inline size_t SpringEngine::getNumAwake() const
+{
+	return track<float>().awake + track<vec2>().awake + track<vec3>().awake + track<vec4>().awake;
+}
+
+inline uint32_t SpringEngine::allocSlot()
+{
+	uint32_t index;
+	if ( !m_freeSlots.empty() ) {
+		index = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	} else {
+		index = ( uint32_t )m_slots.size();
+		m_slots.emplace_back();
+	}
+	m_slots[index].isUsed = true;
+	return index;
+}
+
+inline void SpringEngine::freeSlot( uint32_t index )
+{
+	auto& slot = m_slots[index];
+	switch ( slot.type ) {
+		case 0: removeFromTrack<float>( index ); break;
+		case 1: removeFromTrack<vec2>( index ); break;
+		case 2: removeFromTrack<vec3>( index ); break;
+		case 3: removeFromTrack<vec4>( index ); break;
+	}
+	slot.onRest = nullptr;
+	slot.isUsed = false;
+	++slot.generation;
+	m_freeSlots.push_back( index );
+}
+
+inline bool SpringEngine::remove( SpringId id )
+{
+	if ( !findSlot( id ) )
+		return false;
+	freeSlot( slotIndex( id ) );
+	return true;
+}
+
+inline void SpringEngine::update()
+{
+	auto now = m_clock ? m_clock->now() : Clock::now();
+	if ( now == m_lastUpdate )
+		return;  // i.e. several scenes updating in one frame
+	double seconds = m_lastUpdate == TimePoint() ? 0. : std::chrono::duration<double>( now - m_lastUpdate ).count();
+	m_lastUpdate   = now;
+	if ( seconds <= 0. )
+		return;
+
+	// after a stall, don't try to catch up
+	seconds   = std::min( seconds, .1 );
+	int steps = std::max( 1, ( int )std::ceil( seconds / m_maxStep ) );
+	float dt  = float( seconds / steps );
+
+	m_rested.clear();
+	integrateTrack( track<float>(), dt, steps );
+	integrateTrack( track<vec2>(), dt, steps );
+	integrateTrack( track<vec3>(), dt, steps );
+	integrateTrack( track<vec4>(), dt, steps );
+
+	// fire callbacks after the pass - they may retarget, add or remove springs
+	m_callbacks.clear();
+	for ( auto index : m_rested ) {
+		if ( m_slots[index].onRest )
+			m_callbacks.push_back( m_slots[index].onRest );
+	}
+	for ( auto& callback : m_callbacks ) {
+		try {
+			callback();
+		} catch ( std::exception& e ) {
+			// todo: log exception
+		}
+	}
+	m_callbacks.clear();
+}
+
+inline void SpringEngine::clear()
+{
+	for ( uint32_t i = 0; i < m_slots.size(); ++i ) {
+		if ( m_slots[i].isUsed )
+			freeSlot( i );
+	}
+}
+
+}  // namespace ga
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "ga/timer.h"
 
@@ -29,10 +31,17 @@ struct Timeout
 	}
 };
 
+// identifies a scheduled Timeout - stays unique after the timeout fires or is cancelled, 0 is never valid
+using TimeoutHandle = uint64_t;
+
 //
 // TimeoutManager
 // owns a set of function callbacks that fire after a specified wait
 //
+// timeouts live in reusable slots, and are ordered by a min-heap of end times:
+// scheduling is O(log n), cancelling is O(1) (the heap entry goes stale and is skipped),
+// and updateTimeouts() only touches the timeouts that are due.
+//
 
 class TimeoutManager
 {
@@ -40,89 +49,346 @@ class TimeoutManager
 public:
 	// -----------------------------------------------------------------------------------
 	// register a Timeout callback to be called 'delayMs' milliseconds from now
+	// returns a handle for cancelTimeout() / isScheduled() - cheaper than setTimeout(), which names it
+	// -----------------------------------------------------------------------------------
+	inline TimeoutHandle addTimeout( long long delayMs, std::function<void( void )> callback )
+	{
+		if ( !callback ) return 0;
+
+		uint32_t index        = allocSlot();
+		auto& slot            = m_slots[index];
+		slot.timeout.callback = std::move( callback );
+		slot.timeout.timer.setClock( m_clock );
+		slot.timeout.timer.startNow( ( long )delayMs );
+		pushHeap( slot.timeout.timer.getEnd(), index );
+		return makeHandle( index, slot.generation );
+	}
+
+	// -----------------------------------------------------------------------------------
+	// register a named Timeout, to be cancelled by name
 	// returns the name of the Timeout (generated from the function pointer if left blank)
 	// -----------------------------------------------------------------------------------
 	inline std::string setTimeout( long long delayMs, std::function<void( void )> callback, std::string name = "" )
 	{
 		if ( !callback ) return "";
 
-		m_timeouts.push_back( Timeout() );
-		m_timeouts.back().callback = callback;
-		m_timeouts.back().timer.startNow( delayMs );
-
 		if ( name.empty() ) {
 			// use the callback pointer address as the name, if name is empty
 			// get underlying address of function ptr - https://stackoverflow.com/a/44236212/5195277
 			std::stringstream ss;
-			ss << *( size_t* )( char* )&m_timeouts.back().callback;
+			ss << *( size_t* )( char* )&callback;
 			name = ss.str();
 		}
 
-		m_timeouts.back().name = name;
-
-		// sort the timeouts chronologically (by end time)
-		std::sort( m_timeouts.begin(), m_timeouts.end(),
-		           []( Timeout& a, Timeout& b ) {
-			           return a.timer.getEnd() < b.timer.getEnd();
-		           } );
+		auto handle = addTimeout( delayMs, std::move( callback ) );
+		m_slots[slotIndex( handle )].timeout.name = name;
+		m_names.emplace( name, handle );
 		return name;
 	}
 
+	// -----------------------------------------------------------------------------------
+	// register a callback to be called every 'periodMs' milliseconds, starting 'periodMs' from now
+	// runs until cancelTimeout( handle ) - which is also safe to call from the callback
+	// BURST fires at most 'maxBurst' times per updateTimeouts(), then skips the rest of the missed periods,
+	// so a long stall (i.e. a breakpoint) can't turn into thousands of calls in one frame
+	// -----------------------------------------------------------------------------------
+	enum class CatchUp
+	{
+		SKIP,  // after a long frame, fire once and skip the missed periods
+		BURST  // after a long frame, fire once for every missed period (up to maxBurst)
+	};
+
+	inline TimeoutHandle setInterval( long long periodMs, std::function<void( void )> callback, CatchUp catchUp = CatchUp::SKIP, int maxBurst = 10 )
+	{
+		if ( periodMs <= 0 ) return 0;
+
+		auto handle = addTimeout( periodMs, std::move( callback ) );
+		if ( handle ) {
+			auto& slot   = m_slots[slotIndex( handle )];
+			slot.period  = std::chrono::duration_cast<Clock::duration>( Millis( periodMs ) );
+			slot.catchUp  = catchUp;
+			slot.maxBurst = std::max( maxBurst, 1 );
+		}
+		return handle;
+	}
+
 	// ------------------------
 	// fire and remove timeouts
 	// ------------------------
 	inline void updateTimeouts()
 	{
+		auto now     = m_clock ? m_clock->now() : Clock::now();
+		auto lastSeq = m_nextSeq;  // timeouts set from callbacks wait for the next update
+		++m_updateCount;
+
+		while ( !m_heap.empty() && m_heap.front().time <= now && m_heap.front().seq < lastSeq ) {
+			auto entry = m_heap.front();
+			popHeap();
+			auto& slot = m_slots[entry.slot];
+			if ( slot.generation != entry.generation || !slot.isUsed )
+				continue;  // cancelled
 
-		m_timeouts.erase(
-		    std::remove_if( m_timeouts.begin(), m_timeouts.end(), []( ga::Timeout& evt ) -> bool {
-			    if ( evt.timer.isDone() ) {
-				    if ( evt.callback ) {
-					    try {
-						    evt.callback();
-						    // TODO: ga::log
-						    // ga::log::verbose << "[" << evt.name << "] Timeout fired";
-					    } catch ( std::exception& e ) {
-						    // TODO: ga::log
-						    std::cout << "ERROR [" << evt.name << "] Timeout callback exception:\n\t" << e.what() << std::endl;
-					    }
-				    }
-				    return true;
-			    }
-			    return !evt.timer.isSet();  // prune unset events
-		    } ),
-		    m_timeouts.end() );
+			if ( slot.period != Clock::duration::zero() ) {
+				fireInterval( entry, now );
+				continue;
+			}
+
+			// free the slot before calling, so the callback can schedule / cancel freely
+			auto callback = std::move( slot.timeout.callback );
+			auto name     = std::move( slot.timeout.name );
+			freeSlot( entry.slot, name, false );
+			fire( callback, name );
+		}
 	}
 
 	// ------------------------
-	// cancel a timeout by name
+	// cancel a timeout by handle
 	// ------------------------
-	inline bool cancelTimeout( std::string name )
+	inline bool cancelTimeout( TimeoutHandle handle )
 	{
-		bool did = false;
+		auto index = slotIndex( handle );
+		if ( !isScheduled( handle ) )
+			return false;
+		auto name = m_slots[index].timeout.name;
+		freeSlot( index, name, true );
+		return true;
+	}
 
-		m_timeouts.erase(
-		    std::remove_if( m_timeouts.begin(), m_timeouts.end(), [&]( Timeout& evt ) -> bool {
-			    if ( evt.name == name ) {
-				    evt.clear();
-				    return did = true;
-			    }
-			    return false;
-		    } ),
-		    m_timeouts.end() );
-		return did;
+	// ------------------------
+	// cancel timeouts by name
+	// ------------------------
+	inline bool cancelTimeout( const std::string& name )
+	{
+		auto range = m_names.equal_range( name );
+		if ( range.first == range.second )
+			return false;
+		std::vector<TimeoutHandle> handles;
+		for ( auto it = range.first; it != range.second; ++it ) {
+			handles.push_back( it->second );
+		}
+		for ( auto handle : handles ) {
+			cancelTimeout( handle );
+		}
+		return true;
 	}
 
-	// ---------------------------------------
-	// return the registered timeout callbacks
-	// ---------------------------------------
-	inline std::vector<Timeout>& getTimeouts()
+	inline bool isScheduled( TimeoutHandle handle ) const
 	{
+		auto index = slotIndex( handle );
+		return handle && index < m_slots.size() && m_slots[index].isUsed && m_slots[index].generation == ( uint32_t )( handle >> 32 );
+	}
+
+	inline void clear()
+	{
+		// keep slots (and their generations), so old handles stay invalid
+		for ( uint32_t i = 0; i < m_slots.size(); ++i ) {
+			if ( m_slots[i].isUsed ) {
+				m_slots[i].timeout.clear();
+				m_slots[i].isUsed = false;
+				++m_slots[i].generation;
+				m_freeSlots.push_back( i );
+			}
+		}
+		m_heap.clear();
+		m_names.clear();
+		m_timeouts.clear();  // drop the snapshot's callbacks too
+		m_staleCount = 0;
+	}
+
+	inline size_t size() const
+	{
+		return m_slots.size() - m_freeSlots.size();
+	}
+
+	// -------------------------------------------------------------------
+	// set the clock timeouts are timed with (see Timer::setClock)
+	// -------------------------------------------------------------------
+	inline void setClock( FrameClock* clock )
+	{
+		m_clock = clock;
+		for ( auto& slot : m_slots ) {
+			slot.timeout.timer.setClock( clock );
+		}
+	}
+
+	inline FrameClock* getClock() const
+	{
+		return m_clock;
+	}
+
+	// -----------------------------------------------------------------
+	// return the scheduled timeouts, in firing order (for debugging)
+	// NOTE: a snapshot, not the live list - use cancelTimeout() to remove one.
+	// it's refreshed (in place) by the next call, so copy it to keep it
+	// -----------------------------------------------------------------
+	inline const std::vector<Timeout>& getTimeouts() const
+	{
+		m_timeouts.clear();
+		for ( auto& slot : m_slots ) {
+			if ( slot.isUsed )
+				m_timeouts.push_back( slot.timeout );
+		}
+		std::stable_sort( m_timeouts.begin(), m_timeouts.end(),
+		                  []( const Timeout& a, const Timeout& b ) {
+			                  return a.timer.getEnd() < b.timer.getEnd();
+		                  } );
 		return m_timeouts;
 	}
 
 protected:
-	std::vector<Timeout> m_timeouts;
+	struct Slot
+	{
+		Timeout timeout;
+		Clock::duration period = Clock::duration::zero();  // intervals only
+		CatchUp catchUp        = CatchUp::SKIP;
+		int maxBurst           = 10;
+		int burstCount         = 0;  // calls in burstUpdate
+		uint64_t burstUpdate   = 0;
+		uint32_t generation    = 1;  // bumped when freed, so old handles and heap entries go stale
+		bool isUsed            = false;
+	};
+
+	struct HeapEntry
+	{
+		TimePoint time;
+		uint64_t seq;  // insertion order, so equal times fire first-in first-out
+		uint32_t slot;
+		uint32_t generation;
+
+		bool operator>( const HeapEntry& other ) const
+		{
+			return time != other.time ? time > other.time : seq > other.seq;
+		}
+	};
+
+	static TimeoutHandle makeHandle( uint32_t index, uint32_t generation ) { return ( ( TimeoutHandle )generation << 32 ) | ( index + 1 ); }
+	static uint32_t slotIndex( TimeoutHandle handle ) { return ( uint32_t )( handle & 0xffffffff ) - 1; }
+
+	inline uint32_t allocSlot()
+	{
+		uint32_t index;
+		if ( !m_freeSlots.empty() ) {
+			index = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		} else {
+			index = ( uint32_t )m_slots.size();
+			m_slots.emplace_back();
+		}
+		m_slots[index].isUsed = true;
+		return index;
+	}
+
+	inline void freeSlot( uint32_t index, const std::string& name, bool isInHeap )
+	{
+		auto& slot = m_slots[index];
+		if ( !name.empty() ) {
+			auto handle = makeHandle( index, slot.generation );
+			auto range  = m_names.equal_range( name );
+			for ( auto it = range.first; it != range.second; ++it ) {
+				if ( it->second == handle ) {
+					m_names.erase( it );
+					break;
+				}
+			}
+		}
+		slot.timeout.clear();
+		slot.period     = Clock::duration::zero();
+		slot.burstCount = 0;
+		slot.isUsed     = false;
+		++slot.generation;
+		m_freeSlots.push_back( index );
+
+		// the slot's heap entry is now stale - compact once stale entries dominate the heap
+		if ( isInHeap && ++m_staleCount > 64 && m_staleCount > m_heap.size() / 2 ) {
+			compactHeap();
+		}
+	}
+
+	inline void fire( std::function<void( void )>& callback, const std::string& name )
+	{
+		if ( !callback )
+			return;
+		try {
+			callback();
+			// TODO: ga::log
+			// ga::log::verbose << "[" << name << "] Timeout fired";
+		} catch ( std::exception& e ) {
+			// TODO: ga::log
+			std::cout << "ERROR [" << name << "] Timeout callback exception:\n\t" << e.what() << std::endl;
+		}
+	}
+
+	// call an interval in place, then re-arm it from its scheduled time (not from now), so it doesn't drift
+	inline void fireInterval( const HeapEntry& entry, const TimePoint& now )
+	{
+		// the callback is moved (not copied) out while it runs, in case slots reallocate
+		auto callback = std::move( m_slots[entry.slot].timeout.callback );
+		auto name     = m_slots[entry.slot].timeout.name;  // empty for intervals, so no allocation
+		fire( callback, name );
+
+		auto& slot = m_slots[entry.slot];
+		if ( slot.generation != entry.generation || !slot.isUsed )
+			return;  // cancelled from its callback
+		slot.timeout.callback = std::move( callback );
+
+		bool isBurst = slot.catchUp == CatchUp::BURST;
+		if ( isBurst ) {
+			if ( slot.burstUpdate != m_updateCount ) {
+				slot.burstUpdate = m_updateCount;
+				slot.burstCount  = 0;
+			}
+			isBurst = ++slot.burstCount < slot.maxBurst;  // out of budget - skip like SKIP
+		}
+
+		auto next = entry.time + slot.period;
+		if ( !isBurst && next <= now ) {
+			next += slot.period * ( ( now - next ) / slot.period + 1 );
+		}
+		slot.timeout.timer.set( next - slot.period, next );
+
+		// bursts keep their sequence number, so missed periods fire in this update
+		auto seq = isBurst ? entry.seq : m_nextSeq++;
+		m_heap.push_back( { next, seq, entry.slot, entry.generation } );
+		std::push_heap( m_heap.begin(), m_heap.end(), std::greater<HeapEntry>() );
+	}
+
+	inline void pushHeap( const TimePoint& time, uint32_t index )
+	{
+		m_heap.push_back( { time, m_nextSeq++, index, m_slots[index].generation } );
+		std::push_heap( m_heap.begin(), m_heap.end(), std::greater<HeapEntry>() );
+	}
+
+	inline void popHeap()
+	{
+		std::pop_heap( m_heap.begin(), m_heap.end(), std::greater<HeapEntry>() );
+		auto& entry = m_heap.back();
+		auto& slot  = m_slots[entry.slot];
+		if ( slot.generation != entry.generation || !slot.isUsed )
+			m_staleCount = m_staleCount ? m_staleCount - 1 : 0;
+		m_heap.pop_back();
+	}
+
+	inline void compactHeap()
+	{
+		m_heap.erase( std::remove_if( m_heap.begin(), m_heap.end(),
+		                              [this]( const HeapEntry& e ) {
+			                              auto& slot = m_slots[e.slot];
+			                              return slot.generation != e.generation || !slot.isUsed;
+		                              } ),
+		              m_heap.end() );
+		std::make_heap( m_heap.begin(), m_heap.end(), std::greater<HeapEntry>() );
+		m_staleCount = 0;
+	}
+
+	std::vector<Slot> m_slots;
+	std::vector<uint32_t> m_freeSlots;
+	std::vector<HeapEntry> m_heap;  // min-heap by time
+	std::unordered_multimap<std::string, TimeoutHandle> m_names;
+	uint64_t m_nextSeq     = 0;
+	uint64_t m_updateCount = 0;  // updateTimeouts() calls, for burst limits
+	size_t m_staleCount    = 0;  // cancelled entries still in m_heap
+	mutable std::vector<Timeout> m_timeouts;  // getTimeouts() snapshot (scratch)
+	FrameClock* m_clock = &getFrameClock();
 };
 
 }  // namespace ga
@@ -3,6 +3,7 @@
 namespace ga {
 
 Timer::Timer()
+    : m_clock( &getFrameClock() )
 {
 }
 
@@ -32,7 +33,7 @@ void Timer::clear()
 
 void Timer::startNow()
 {
-	mBegin_t = Clock::now();
+	mBegin_t = now();
 }
 
 void Timer::startNow( long durationMillis )
@@ -45,12 +46,12 @@ void Timer::startNow( long durationMillis )
 
 double Timer::duration()
 {
-	return static_cast<double>( durMillis( mBegin_t, mEnd_t ) );
+	return std::chrono::duration<double, std::milli>( mEnd_t - mBegin_t ).count();
 }
 
 double Timer::elapsedMillis()
 {
-	return static_cast<double>( durMillis( mBegin_t, Clock::now() ) );
+	return std::chrono::duration<double, std::milli>( now() - mBegin_t ).count();
 }
 
 double Timer::elapsedSeconds()
@@ -1,5 +1,6 @@
 #pragma once
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <string>
@@ -38,6 +39,103 @@ inline std::ostream& operator<<( std::ostream& stream, const TimePoint& timePoin
 	return stream << timeMillis( timePoint );
 }
 
+// ---------------------
+// FrameClock class
+// ---------------------
+
+// a snapshot of the time, taken once per frame - so every Timer / Tween / Timeout
+// reads the same 'now' within a frame, without a Clock::now() call each time.
+// frame time can be scaled or paused - it runs alongside Clock time, starting from the first advance().
+// in manual mode, time only moves with step(), i.e. for deterministic offline runs (see Simulation).
+class FrameClock
+{
+public:
+	// take the snapshot - called at the start of Scene::update()
+	void advance()
+	{
+		if ( m_isManual )
+			return;
+		auto real = Clock::now();
+		if ( !m_hasAdvanced ) {
+			m_now         = real;
+			m_hasAdvanced = true;
+		} else if ( m_isPaused ) {
+			m_delta = Clock::duration::zero();
+		} else {
+			m_delta = std::chrono::duration_cast<Clock::duration>( ( real - m_lastReal ) * m_timeScale );
+			m_now += m_delta;
+		}
+		m_lastReal = real;
+		++m_frameCount;
+	}
+
+	// move time forward by a fixed amount (scaled, unless paused)
+	void step( Clock::duration dt )
+	{
+		if ( !m_hasAdvanced ) {
+			m_now         = Clock::now();
+			m_hasAdvanced = true;
+		}
+		m_delta = m_isPaused ? Clock::duration::zero() : std::chrono::duration_cast<Clock::duration>( dt * m_timeScale );
+		m_now += m_delta;
+		++m_frameCount;
+	}
+	void step( double seconds ) { step( std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( seconds ) ) ); }
+
+	// when manual, advance() does nothing - time continues from where it is when switching,
+	// and realtime resumes from the switch back
+	void setManual( bool manual = true )
+	{
+		if ( m_isManual && !manual )
+			m_lastReal = Clock::now();
+		m_isManual = manual;
+	}
+	bool isManual() const { return m_isManual; }
+
+	// Clock::now() until the first advance() / step()
+	TimePoint now() const
+	{
+		if ( m_isHeld )
+			return m_heldTime;
+		return m_hasAdvanced ? m_now : Clock::now();
+	}
+
+	// report an earlier time within the current frame, until release()
+	// i.e. for fixed rate update steps, which each run at their own time (see Scene::setFixedUpdateRate)
+	void hold( const TimePoint& time )
+	{
+		m_heldTime = time;
+		m_isHeld   = true;
+	}
+	void release() { m_isHeld = false; }
+
+	void setTimeScale( double timeScale ) { m_timeScale = timeScale; }
+	double getTimeScale() const { return m_timeScale; }
+
+	void setPaused( bool paused = true ) { m_isPaused = paused; }
+	bool isPaused() const { return m_isPaused; }
+
+	double getDeltaSeconds() const { return std::chrono::duration<double>( m_delta ).count(); }  // scaled, since the previous frame
+	uint64_t getFrameCount() const { return m_frameCount; }
+
+protected:
+	TimePoint m_now, m_lastReal, m_heldTime;
+	Clock::duration m_delta = Clock::duration::zero();
+	double m_timeScale      = 1.;
+	bool m_isPaused         = false;
+	bool m_isManual         = false;
+	bool m_isHeld           = false;
+	bool m_hasAdvanced      = false;
+	uint64_t m_frameCount   = 0;
+};
+
+// singleton, advanced by Scene::update()
+inline FrameClock& getFrameClock()
+{
+	static FrameClock c;
+	return c;
+}
+
 // ---------------------
 // Timer class
 // ---------------------
@@ -66,17 +164,32 @@ public:
 	inline virtual bool hasStart() { return mBegin_t != TimePoint(); }
 	inline virtual bool hasEnd() { return mEnd_t != TimePoint(); }
 	inline virtual bool isSet() { return hasStart() && hasEnd(); }
-	inline virtual bool isStarted() { return hasStart() && Clock::now() >= mBegin_t; }
-	inline virtual bool isDone() { return hasEnd() && Clock::now() >= mEnd_t; }
-	inline virtual bool isActive() { return hasStart() && Clock::now() >= mBegin_t && ( hasEnd() ? Clock::now() < mEnd_t : true ); }
+	inline virtual bool isStarted() { return hasStart() && now() >= mBegin_t; }
+	inline virtual bool isDone() { return hasEnd() && now() >= mEnd_t; }
+	inline virtual bool isActive()
+	{
+		if ( !hasStart() )
+			return false;
+		auto t = now();
+		return t >= mBegin_t && ( hasEnd() ? t < mEnd_t : true );
+	}
 
 	double duration();
 	double elapsedMillis();
 	double elapsedSeconds();
 	double elapsedPercent();
 
+	// -------- time source
+
+	// the frame clock timers read 'now' from - getFrameClock() by default, nullptr for Clock::now()
+	void setClock( FrameClock* clock ) { m_clock = clock; }
+	FrameClock* getClock() const { return m_clock; }
+
+	TimePoint now() const { return m_clock ? m_clock->now() : Clock::now(); }
+
 protected:
 	TimePoint mBegin_t, mEnd_t;
+	FrameClock* m_clock;
 };
 
 }  // namespace ga
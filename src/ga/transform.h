@@ -32,12 +32,28 @@ public:
 		flagDirty();
 	}
 
+	Transform( const Transform& other ) = default;
+
+	virtual ~Transform() = default;
+
+	inline Transform& operator=( const Transform& other )
+	{
+		m_translation = other.m_translation;
+		m_scale       = other.m_scale;
+		m_rotation    = other.m_rotation;
+		m_transform   = other.m_transform;
+		m_dirty       = other.m_dirty;
+		onTransformChange();
+		return *this;
+	}
+
 	// setters
 
 	inline Transform& setMatrix( const mat4& matrix )
 	{
 		m_transform = matrix;
 		decompose();
+		onTransformChange();
 		return *this;
 	}
 
@@ -119,7 +135,15 @@ protected:
 	mat4 m_transform;
 	bool m_dirty;  // matrix needs rebuilding
 
-	inline void flagDirty() { m_dirty = true; }
+	inline void flagDirty()
+	{
+		m_dirty = true;
+		onTransformChange();
+	}
+
+	// called after any change to translation, rotation, scale or matrix
+	// useful for things that cache derived transforms, i.e. scene space matrices
+	virtual void onTransformChange() {}
 
 	inline void clean() const
 	{
@@ -1,7 +1,9 @@
 #pragma once
 #include "ga/easing.h"
 #include "ga/math.h"
+#include "ga/property.h"
 #include "ga/signal.h"
+#include "ga/small_function.h"
 #include "ga/timer.h"
 
 namespace ga {
@@ -20,28 +22,33 @@ protected:
 	virtual bool isDone_()                = 0;
 	virtual bool isStarted_()             = 0;
 	virtual void end( bool fireCallback ) = 0;
+	virtual void seek_( float pct )       = 0;
 };
 
 // Tween class
-template <typename T>
+// the ease is a std::function by default (empty is linear) - or an ease functor type (i.e. ease::ExpoOut),
+// which inlines the curve into update(), at the cost of fixing it at compile time
+template <typename T, typename Ease = EasingFn>
 class Tween : public TweenBase, public Timer
 {
 public:
-	Tween( const T& startVal, const T& endVal, std::function<float( float )> easeFn )
+	Tween( const T& startVal, const T& endVal, Ease easeFn = Ease() )
 	    : Timer()
 	    , m_startVal( startVal )
 	    , m_endVal( endVal )
 	    , m_easeFn( easeFn )
+	    , m_easeFnType( easeTypeOf( m_easeFn ) )
 	    , m_onDone( nullptr )
 	    , m_boundPtr( nullptr )
 	{
 	}
-	Tween( const T& startVal, const T& endVal, std::function<float( float )> easeFn, std::function<void()> onDone )
+	Tween( const T& startVal, const T& endVal, Ease easeFn, Callback onDone )
 	    : Timer()
 	    , m_startVal( startVal )
 	    , m_endVal( endVal )
 	    , m_easeFn( easeFn )
-	    , m_onDone( onDone )
+	    , m_easeFnType( easeTypeOf( m_easeFn ) )
+	    , m_onDone( std::move( onDone ) )
 	    , m_boundPtr( nullptr )
 	{
 	}
@@ -49,9 +56,9 @@ public:
 
 	friend class Timeline;
 
-	Tween& set( const T& startVal, const T& endVal, std::function<float( float )> easeFn, std::function<void()> onDone = nullptr )
+	Tween& set( const T& startVal, const T& endVal, Ease easeFn, Callback onDone = nullptr )
 	{
-		return setStartVal( startVal ).setEndVal( endVal ).setEaseFn( easeFn ).setOnDone( onDone );
+		return setStartVal( startVal ).setEndVal( endVal ).setEaseFn( easeFn ).setOnDone( std::move( onDone ) );
 	}
 
 	Tween& setStartVal( const T& startVal )
@@ -64,22 +71,25 @@ public:
 		m_endVal = endVal;
 		return *this;
 	}
-	Tween& setEaseFn( ga::EaseType easeFnType )
+	Tween& setEaseFn( Ease easeFn )
 	{
-		m_easeFnType = easeFnType;
-		m_easeFn     = ga::easeFn( easeFnType );
+		m_easeFn     = std::move( easeFn );
+		m_easeFnType = easeTypeOf( m_easeFn );
 		return *this;
 	}
-	Tween& setEaseFn( std::function<float( float )> easeFn )
+	// by type - needs the default, std::function Ease
+	template <typename E = Ease, typename = std::enable_if_t<std::is_same<E, EasingFn>::value>>
+	Tween& setEaseFn( ga::EaseType easeFnType )
 	{
-		m_easeFnType = ga::EaseType::CUSTOM;
-		m_easeFn     = easeFn;
+		m_easeFn     = ga::easeFn( easeFnType );
+		m_easeFnType = easeFnType;
 		return *this;
 	}
+	ga::EaseType getEaseFnType() const { return m_easeFnType; }
 	// assign callback on done
-	Tween& setOnDone( std::function<void()> onDone )
+	Tween& setOnDone( Callback onDone )
 	{
-		m_onDone = onDone;
+		m_onDone = std::move( onDone );
 		return *this;
 	}
 
@@ -89,9 +99,16 @@ public:
 		m_boundPtr = ptr;
 		return *this;
 	}
+	// bind a property (i.e. node->getTranslationProperty()) - safe if its owner is destroyed first
+	Tween& bind( Property<T> property )
+	{
+		m_boundProperty = property;
+		return *this;
+	}
 	Tween& unbind()
 	{
 		m_boundPtr = nullptr;
+		m_boundProperty.reset();
 		return *this;
 	}
 
@@ -116,7 +133,7 @@ public:
 
 	void startAfterDelay( long delayMs, long durationMs )
 	{
-		auto start = ga::Clock::now() + ga::Millis( delayMs );
+		auto start = Timer::now() + ga::Millis( delayMs );
 		Timer::setStart( start );
 		Timer::setEnd( start + ga::Millis( durationMs ) );
 	}
@@ -125,7 +142,7 @@ public:
 	const T& update()
 	{
 		if ( Timer::isSet() && Timer::isActive() ) {  // current time is between begin and end
-			m_val = ga::interpolate( m_startVal, m_endVal, Timer::elapsedPercent(), m_easeFn, true );
+			m_val = valueAt( Timer::elapsedPercent() );
 			updateBoundPtr();
 		}
 		if ( Timer::isDone() ) {
@@ -141,14 +158,39 @@ public:
 		return m_val;
 	}
 
+	// jump to 'pct' (0-1) of the animation, regardless of the timer and without callbacks (i.e. for scrubbing)
+	const T& seek( float pct )
+	{
+		m_val = valueAt( ga::clamp( pct, 0.f, 1.f ) );
+		updateBoundPtr();
+		return m_val;
+	}
+
 protected:
 	T m_val, m_startVal, m_endVal;           // val tweens from startVal to endVal
-	std::function<float( float )> m_easeFn;  // easing function: p = f(t) - see Ease.h
-	ga::EaseType m_easeFnType;
-	std::function<void()> m_onDone;  // callback
-	T* m_boundPtr;
+	Ease m_easeFn;  // easing function: p = f(t) - see Ease.h
+	ga::EaseType m_easeFnType = easeTypeOf( m_easeFn );
+	Callback m_onDone;  // callback (small ones are stored inline)
+	T* m_boundPtr = nullptr;
+	Property<T> m_boundProperty;
+
+	T valueAt( float pct ) const
+	{
+		return ga::lerp( m_startVal, m_endVal, ga::clamp( applyEaseFn( m_easeFn, pct ), 0.f, 1.f ) );
+	}
+
+	// std::functions are CUSTOM unless empty (linear) - ease:: functors carry their EaseType, other functors and lambdas are CUSTOM
+	// (the functor overload is an exact match, so it never competes with the conversion to EasingFn)
+	static ga::EaseType easeTypeOf( const EasingFn& easeFn ) { return easeFn ? ga::EaseType::CUSTOM : ga::EaseType::LINEAR; }
+	template <typename E, typename = std::enable_if_t<!std::is_same<E, EasingFn>::value>>
+	static constexpr ga::EaseType easeTypeOf( const E& ) { return functorEaseType<E>( 0 ); }
+	template <typename E>
+	static constexpr auto functorEaseType( int ) -> decltype( E::type, ga::EaseType() ) { return E::type; }
+	template <typename E>
+	static constexpr ga::EaseType functorEaseType( long ) { return ga::EaseType::CUSTOM; }
 	bool updateBoundPtr()
 	{
+		m_boundProperty.set( m_val );
 		auto ptr = m_boundPtr;
 		if ( ptr ) {
 			try {
@@ -183,7 +225,7 @@ protected:
 		// Timer::update()
 		if ( Timer::isSet() ) {
 			if ( Timer::isActive() ) {  // current time is between begin and end
-				m_val = ga::interpolate( m_startVal, m_endVal, Timer::elapsedPercent(), m_easeFn, true );
+				m_val = valueAt( Timer::elapsedPercent() );
 			} else if ( Timer::isDone() ) {
 				m_val = m_endVal;
 			}
@@ -201,6 +243,11 @@ protected:
 	{
 		return Timer::isStarted();
 	}
+
+	void seek_( float pct ) override
+	{
+		seek( pct );
+	}
 };
 
 }  // namespace ga
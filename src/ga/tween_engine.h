@@ -0,0 +1,587 @@
+#pragma once
+#include "ga/easing.h"
+#include "ga/math.h"
+#include "ga/property.h"
+#include "ga/small_function.h"
+#include "ga/timer.h"
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+namespace ga {
+
+// identifies a tween in a TweenEngine - stays unique after the tween ends, 0 is never valid
+using TweenId = uint64_t;
+
+/**
+ * @brief TweenEngine evaluates many tweens per frame, stored as structure-of-arrays.
+ *
+ * Each value type (float, vec2, vec3, vec4, quat) has its own track of contiguous arrays,
+ * evaluated in three flat passes: progress, easing, then interpolation - the first and last
+ * are simple enough for the compiler to vectorize. Finished tweens are swap-removed,
+ * so arrays never shrink or reallocate once warmed up.
+ *
+ * Only tweens added here (directly, or through BatchTween) are batched - Tween<T> and the tweens
+ * Timeline creates are still updated one by one, by their owners.
+ */
+class TweenEngine
+{
+public:
+	// start a tween 'delaySec' from now - the bound value (if any) is written every update while it runs
+	template <typename T>
+	TweenId add( const T& from, const T& to, double durationSec, EaseType ease = EaseType::DEFAULT, T* bound = nullptr, double delaySec = 0.,
+	             Callback onDone = nullptr );
+
+	// with a custom (type-erased) ease function
+	template <typename T>
+	TweenId add( const T& from, const T& to, double durationSec, std::function<float( float )> easeFn, T* bound = nullptr, double delaySec = 0.,
+	             Callback onDone = nullptr );
+
+	// stop a tween, optionally jumping to (and binding) its end value and firing its onDone callback
+	bool remove( TweenId id, bool finish = false );
+
+	bool isActive( TweenId id ) const;
+
+	// the tween's current value, or nullptr if it has ended (or T is the wrong type)
+	template <typename T>
+	const T* getValue( TweenId id ) const;
+
+	template <typename T>
+	bool bind( TweenId id, T* ptr );
+
+	// bind a property (i.e. node->getTranslationProperty()) - skipped once its owner is destroyed
+	template <typename T>
+	bool bind( TweenId id, Property<T> property );
+
+	bool setOnDone( TweenId id, Callback onDone );
+
+	// evaluate every tween - called by Scene::update(), only once per clock time
+	void update();
+
+	size_t size() const { return m_slots.size() - m_freeSlots.size(); }
+	void clear();
+
+	// the clock tweens are timed with - getFrameClock() by default, nullptr for Clock::now()
+	void setClock( FrameClock* clock ) { m_clock = clock; }
+	FrameClock* getClock() const { return m_clock; }
+
+protected:
+	template <typename T>
+	struct Track
+	{
+		std::vector<T> from, to, value;
+		std::vector<double> start;       // seconds since m_epoch
+		std::vector<float> invDuration;  // 1 / seconds
+		std::vector<float> progress;     // eased 0-1, per update
+		std::vector<EaseType> ease;
+		std::vector<T*> bound;
+		std::vector<Property<T>> property;
+		std::vector<uint32_t> slots;  // owning slot, for swap-removal
+
+		void removeAt( uint32_t i )
+		{
+			auto last = ( uint32_t )slots.size() - 1;
+			if ( i != last ) {
+				from[i]        = from[last];
+				to[i]          = to[last];
+				value[i]       = value[last];
+				start[i]       = start[last];
+				invDuration[i] = invDuration[last];
+				ease[i]        = ease[last];
+				bound[i]       = bound[last];
+				property[i]    = std::move( property[last] );
+				slots[i]       = slots[last];
+			}
+			from.pop_back();
+			to.pop_back();
+			value.pop_back();
+			start.pop_back();
+			invDuration.pop_back();
+			ease.pop_back();
+			bound.pop_back();
+			property.pop_back();
+			slots.pop_back();
+		}
+	};
+
+	using Tracks = std::tuple<Track<float>, Track<vec2>, Track<vec3>, Track<vec4>, Track<quat>>;
+
+	struct Slot
+	{
+		uint32_t type       = 0;  // index into Tracks
+		uint32_t index      = 0;  // into the track's arrays
+		uint32_t generation = 1;
+		bool isUsed         = false;
+		Callback onDone;
+		std::function<float( float )> easeFn;  // EaseType::CUSTOM only
+	};
+
+	template <typename T>
+	Track<T>& track() { return std::get<Track<T>>( m_tracks ); }
+	template <typename T>
+	const Track<T>& track() const { return std::get<Track<T>>( m_tracks ); }
+
+	template <typename T>
+	static constexpr uint32_t typeIndex();
+
+	template <typename T>
+	void updateTrack( Track<T>& track, double now );
+
+	template <typename T>
+	void removeFromTrack( uint32_t slotIndex );
+
+	const Slot* findSlot( TweenId id ) const;
+	uint32_t allocSlot();
+	void freeSlot( uint32_t index );
+	double nowSeconds() const;
+
+	static TweenId makeId( uint32_t index, uint32_t generation ) { return ( ( TweenId )generation << 32 ) | ( index + 1 ); }
+	static uint32_t slotIndex( TweenId id ) { return ( uint32_t )( id & 0xffffffff ) - 1; }
+
+	Tracks m_tracks;
+	std::vector<Slot> m_slots;
+	std::vector<uint32_t> m_freeSlots;
+	std::vector<uint32_t> m_done;       // slots finished this update (scratch)
+	std::vector<Callback> m_callbacks;  // their onDone callbacks (scratch)
+	FrameClock* m_clock = &getFrameClock();
+	TimePoint m_epoch   = Clock::now();
+	TimePoint m_lastUpdate;
+};
+
+// singleton, updated by Scene::update()
+inline TweenEngine& getTweenEngine()
+{
+	static TweenEngine e;
+	return e;
+}
+
+/**
+ * @brief BatchTween is a Tween<T>-like handle to a tween evaluated by a TweenEngine.
+ *
+ * It owns its tween - destroying it stops the tween - so a bound pointer can't outlive its owner.
+ */
+template <typename T>
+class BatchTween
+{
+public:
+	BatchTween( TweenEngine& engine = getTweenEngine() )
+	    : m_engine( &engine )
+	{
+	}
+	BatchTween( const T& startVal, const T& endVal, EaseType ease = EaseType::DEFAULT, TweenEngine& engine = getTweenEngine() )
+	    : m_engine( &engine )
+	{
+		set( startVal, endVal, ease );
+	}
+	~BatchTween() { stop(); }
+
+	BatchTween( const BatchTween& ) = delete;
+	BatchTween& operator=( const BatchTween& ) = delete;
+	BatchTween( BatchTween&& other ) { *this = std::move( other ); }
+	BatchTween& operator=( BatchTween&& other )
+	{
+		if ( this != &other ) {
+			stop();
+			m_engine        = other.m_engine;
+			m_id            = other.m_id;
+			m_startVal      = other.m_startVal;
+			m_endVal        = other.m_endVal;
+			m_val           = other.m_val;
+			m_easeType      = other.m_easeType;
+			m_easeFn        = std::move( other.m_easeFn );
+			m_onDone        = std::move( other.m_onDone );
+			m_boundPtr      = other.m_boundPtr;
+			m_boundProperty = other.m_boundProperty;
+			other.m_id      = 0;
+		}
+		return *this;
+	}
+
+	BatchTween& set( const T& startVal, const T& endVal, EaseType ease, Callback onDone = nullptr )
+	{
+		return setStartVal( startVal ).setEndVal( endVal ).setEaseFn( ease ).setOnDone( onDone );
+	}
+
+	// start and end values, ease and callback apply from the next start
+	BatchTween& setStartVal( const T& startVal )
+	{
+		m_startVal = startVal;
+		return *this;
+	}
+	BatchTween& setEndVal( const T& endVal )
+	{
+		m_endVal = endVal;
+		return *this;
+	}
+	BatchTween& setEaseFn( EaseType ease )
+	{
+		m_easeType = ease;
+		m_easeFn   = nullptr;
+		return *this;
+	}
+	BatchTween& setEaseFn( std::function<float( float )> easeFn )
+	{
+		m_easeType = EaseType::CUSTOM;
+		m_easeFn   = std::move( easeFn );
+		return *this;
+	}
+	BatchTween& setOnDone( Callback onDone )
+	{
+		m_onDone = std::move( onDone );
+		m_engine->setOnDone( m_id, m_onDone );
+		return *this;
+	}
+
+	// bind a ptr to update with the animation value
+	BatchTween& bind( T* ptr )
+	{
+		m_boundPtr = ptr;
+		m_engine->bind( m_id, ptr );
+		return *this;
+	}
+	BatchTween& bind( Property<T> property )
+	{
+		m_boundProperty = property;
+		m_engine->bind( m_id, property );
+		return *this;
+	}
+	BatchTween& unbind()
+	{
+		bind( Property<T>() );
+		return bind( nullptr );
+	}
+
+	const T& getStartVal() const { return m_startVal; }
+	const T& getEndVal() const { return m_endVal; }
+
+	// the value as of the engine's last update
+	const T& getValue() const
+	{
+		auto val = m_engine->getValue<T>( m_id );
+		return val ? *val : m_val;
+	}
+
+	void startNow( long durationMs ) { startAfterDelay( 0, durationMs ); }
+	void startAfterDelay( long delayMs, long durationMs )
+	{
+		stop();
+		m_val          = m_startVal;
+		double seconds = durationMs / 1000.;
+		double delay   = delayMs / 1000.;
+		if ( m_easeType == EaseType::CUSTOM ) {
+			m_id = m_engine->add( m_startVal, m_endVal, seconds, m_easeFn, m_boundPtr, delay, m_onDone );
+		} else {
+			m_id = m_engine->add( m_startVal, m_endVal, seconds, m_easeType, m_boundPtr, delay, m_onDone );
+		}
+		if ( m_boundProperty )
+			m_engine->bind( m_id, m_boundProperty );
+		m_val = m_endVal;  // once the tween is gone
+	}
+
+	bool isActive() const { return m_engine->isActive( m_id ); }
+	bool isDone() const { return m_id && !isActive(); }  // reached its end (or endNow()) - false after stop()
+
+	// end animation now (optionally firing callback), return end value
+	const T& endNow( bool fireCallback = true )
+	{
+		if ( !fireCallback )
+			m_engine->setOnDone( m_id, nullptr );
+		m_engine->remove( m_id, true );
+		return m_val;
+	}
+
+	// stop where it is, without callback
+	void stop()
+	{
+		if ( !m_engine || !isActive() )
+			return;  // not running - a finished tween stays done
+		m_val = *m_engine->getValue<T>( m_id );
+		m_engine->remove( m_id );
+		m_id = 0;  // stopped, not done
+	}
+
+	TweenId getId() const { return m_id; }
+
+protected:
+	TweenEngine* m_engine = nullptr;
+	TweenId m_id          = 0;
+	T m_startVal, m_endVal, m_val;
+	EaseType m_easeType = EaseType::DEFAULT;
+	std::function<float( float )> m_easeFn;  // EaseType::CUSTOM only
+	Callback m_onDone;
+	T* m_boundPtr = nullptr;
+	Property<T> m_boundProperty;
+};
+
+// template implementations
+// ------------------------
+
+template <>
+constexpr uint32_t TweenEngine::typeIndex<float>() { return 0; }
+template <>
+constexpr uint32_t TweenEngine::typeIndex<vec2>() { return 1; }
+template <>
+constexpr uint32_t TweenEngine::typeIndex<vec3>() { return 2; }
+template <>
+constexpr uint32_t TweenEngine::typeIndex<vec4>() { return 3; }
+template <>
+constexpr uint32_t TweenEngine::typeIndex<quat>() { return 4; }
+
+template <typename T>
+TweenId TweenEngine::add( const T& from, const T& to, double durationSec, EaseType ease, T* bound, double delaySec, Callback onDone )
+{
+	auto index  = allocSlot();
+	auto& t     = track<T>();
+	auto& slot  = m_slots[index];
+	slot.type   = typeIndex<T>();
+	slot.index  = ( uint32_t )t.slots.size();
+	slot.onDone = std::move( onDone );
+
+	t.from.push_back( from );
+	t.to.push_back( to );
+	t.value.push_back( from );
+	t.start.push_back( nowSeconds() + delaySec );
+	t.invDuration.push_back( durationSec > 0. ? ( float )( 1. / durationSec ) : 0.f );  // 0 = finish on the next update
+	t.ease.push_back( ease );
+	t.bound.push_back( bound );
+	t.property.emplace_back();
+	t.slots.push_back( index );
+	return makeId( index, slot.generation );
+}
+
+template <typename T>
+TweenId TweenEngine::add( const T& from, const T& to, double durationSec, std::function<float( float )> easeFn, T* bound, double delaySec, Callback onDone )
+{
+	auto id = add( from, to, durationSec, easeFn ? EaseType::CUSTOM : EaseType::LINEAR, bound, delaySec, std::move( onDone ) );
+	m_slots[slotIndex( id )].easeFn = std::move( easeFn );
+	return id;
+}
+
+template <typename T>
+const T* TweenEngine::getValue( TweenId id ) const
+{
+	auto slot = findSlot( id );
+	if ( !slot || slot->type != typeIndex<T>() )
+		return nullptr;
+	return &track<T>().value[slot->index];
+}
+
+template <typename T>
+bool TweenEngine::bind( TweenId id, T* ptr )
+{
+	auto slot = findSlot( id );
+	if ( !slot || slot->type != typeIndex<T>() )
+		return false;
+	track<T>().bound[slot->index] = ptr;
+	return true;
+}
+
+template <typename T>
+bool TweenEngine::bind( TweenId id, Property<T> property )
+{
+	auto slot = findSlot( id );
+	if ( !slot || slot->type != typeIndex<T>() )
+		return false;
+	track<T>().property[slot->index] = std::move( property );
+	return true;
+}
+
+template <typename T>
+void TweenEngine::updateTrack( Track<T>& t, double now )
+{
+	size_t n = t.slots.size();
+	if ( !n )
+		return;
+	t.progress.resize( n );
+
+	// progress - flat float math
+	float* progress          = t.progress.data();
+	const double* start      = t.start.data();
+	const float* invDuration = t.invDuration.data();
+	for ( size_t i = 0; i < n; ++i ) {
+		float p     = invDuration[i] > 0.f ? ( float )( now - start[i] ) * invDuration[i] : ( now >= start[i] ? 1.f : -1.f );
+		progress[i] = p;
+	}
+
+	// finished tweens, and easing of running ones (not started ones keep their value)
+	size_t firstDone = m_done.size();
+	for ( size_t i = 0; i < n; ++i ) {
+		float p = progress[i];
+		if ( p >= 1.f ) {
+			m_done.push_back( t.slots[i] );
+			progress[i] = 1.f;
+		} else if ( p >= 0.f ) {
+			auto ease   = t.ease[i];
+			progress[i] = ease == EaseType::CUSTOM ? m_slots[t.slots[i]].easeFn( p ) : applyEase( ease, p );
+		}
+	}
+
+	// interpolate
+	const T* from = t.from.data();
+	const T* to   = t.to.data();
+	T* value      = t.value.data();
+	for ( size_t i = 0; i < n; ++i ) {
+		if ( progress[i] >= 0.f )
+			value[i] = ga::lerp( from[i], to[i], progress[i] );
+	}
+
+	// finished tweens land exactly on their end value
+	for ( size_t k = firstDone; k < m_done.size(); ++k ) {
+		auto i   = m_slots[m_done[k]].index;
+		value[i] = to[i];
+	}
+
+	// write bound values
+	for ( size_t i = 0; i < n; ++i ) {
+		if ( progress[i] < 0.f )
+			continue;
+		if ( t.bound[i] )
+			*t.bound[i] = value[i];
+		t.property[i].set( value[i] );
+	}
+}
+
+template <typename T>
+void TweenEngine::removeFromTrack( uint32_t slotIndex )
+{
+	auto& t    = track<T>();
+	auto index = m_slots[slotIndex].index;
+	t.removeAt( index );
+	if ( index < t.slots.size() )
+		m_slots[t.slots[index]].index = index;  // the swapped in tween
+}
+
+// ---------------------------------------------
+// non-template implementations
+
+inline double TweenEngine::nowSeconds() const
+{
+	auto now = m_clock ? m_clock->now() : Clock::now();
+	return std::chrono::duration<double>( now - m_epoch ).count();
+}
+
+inline const TweenEngine::Slot* TweenEngine::findSlot( TweenId id ) const
+{
+	auto index = slotIndex( id );
+	if ( !id || index >= m_slots.size() )
+		return nullptr;
+	auto& slot = m_slots[index];
+	return slot.isUsed && slot.generation == ( uint32_t )( id >> 32 ) ? &slot : nullptr;
+}
+
+inline bool TweenEngine::isActive( TweenId id ) const
+{
+	return findSlot( id ) != nullptr;
+}
+
+inline bool TweenEngine::setOnDone( TweenId id, Callback onDone )
+{
+	if ( !findSlot( id ) )
+		return false;
+	m_slots[slotIndex( id )].onDone = std::move( onDone );
+	return true;
+}
+
+inline uint32_t TweenEngine::allocSlot()
+{
+	uint32_t index;
+	if ( !m_freeSlots.empty() ) {
+		index = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	} else {
+		index = ( uint32_t )m_slots.size();
+		m_slots.emplace_back();
+	}
+	m_slots[index].isUsed = true;
+	return index;
+}
+
+inline void TweenEngine::freeSlot( uint32_t index )
+{
+	auto& slot = m_slots[index];
+	switch ( slot.type ) {
+		case 0: removeFromTrack<float>( index ); break;
+		case 1: removeFromTrack<vec2>( index ); break;
+		case 2: removeFromTrack<vec3>( index ); break;
+		case 3: removeFromTrack<vec4>( index ); break;
+		case 4: removeFromTrack<quat>( index ); break;
+	}
+	slot.onDone = nullptr;
+	slot.easeFn = nullptr;
+	slot.isUsed = false;
+	++slot.generation;
+	m_freeSlots.push_back( index );
+}
+
+inline bool TweenEngine::remove( TweenId id, bool finish )
+{
+	if ( !findSlot( id ) )
+		return false;
+	auto index = slotIndex( id );
+	Callback onDone;
+	if ( finish ) {
+		// jump to the end value
+		auto& slot = m_slots[index];
+		auto snap  = [&]( auto& t ) {
+			t.value[slot.index] = t.to[slot.index];
+			if ( t.bound[slot.index] )
+				*t.bound[slot.index] = t.value[slot.index];
+			t.property[slot.index].set( t.value[slot.index] );
+		};
+		switch ( slot.type ) {
+			case 0: snap( track<float>() ); break;
+			case 1: snap( track<vec2>() ); break;
+			case 2: snap( track<vec3>() ); break;
+			case 3: snap( track<vec4>() ); break;
+			case 4: snap( track<quat>() ); break;
+		}
+		onDone = std::move( slot.onDone );
+	}
+	freeSlot( index );
+	if ( onDone )
+		onDone();
+	return true;
+}
+
+inline void TweenEngine::update()
+{
+	auto now = m_clock ? m_clock->now() : Clock::now();
+	if ( now == m_lastUpdate )
+		return;  // i.e. several scenes updating in one frame
+	m_lastUpdate = now;
+
+	double seconds = std::chrono::duration<double>( now - m_epoch ).count();
+	m_done.clear();
+	updateTrack( track<float>(), seconds );
+	updateTrack( track<vec2>(), seconds );
+	updateTrack( track<vec3>(), seconds );
+	updateTrack( track<vec4>(), seconds );
+	updateTrack( track<quat>(), seconds );
+
+	// remove finished tweens, then fire callbacks - which may add new tweens
+	m_callbacks.clear();
+	for ( auto index : m_done ) {
+		if ( m_slots[index].onDone )
+			m_callbacks.push_back( std::move( m_slots[index].onDone ) );
+		freeSlot( index );
+	}
+	for ( auto& callback : m_callbacks ) {
+		try {
+			callback();
+		} catch ( std::exception& e ) {
+			// todo: log exception
+		}
+	}
+	m_callbacks.clear();
+}
+
+inline void TweenEngine::clear()
+{
+	for ( uint32_t i = 0; i < m_slots.size(); ++i ) {
+		if ( m_slots[i].isUsed )
+			freeSlot( i );
+	}
+}
+
+}  // namespace ga
@@ -0,0 +1,235 @@
+#pragma once
+#include "ga/easing.h"
+#include "ga/math.h"
+#include "ga/timer.h"
+#include "ga/tween.h"
+#include <algorithm>
+#include <vector>
+
+namespace ga {
+
+/**
+ * @brief TweenGroup animates many targets with one curve and duration, each with its own delay and values -
+ * i.e. a staggered reveal across a grid - as one tween, with one update pass and one onDone callback.
+ *
+ *		auto group = std::make_shared<TweenGroup<float>>( 400., easeFn( EaseType::EXPO_OUT ) );
+ *		group->addStaggered( alphas, 0.f, 1.f, 20. );  // 20ms apart
+ *		group->startNow();
+ *		timeline->add( group );
+ */
+template <typename T, typename Ease = EasingFn>
+class TweenGroup : public TweenBase, public Timer
+{
+public:
+	friend class Timeline;
+
+	TweenGroup( double durationMs = 0., Ease easeFn = Ease(), Callback onDone = nullptr )
+	    : Timer()
+	    , m_easeFn( easeFn )
+	    , m_onDone( std::move( onDone ) )
+	{
+		setDuration( durationMs );
+	}
+
+	// add a target, animated from 'from' to 'to' after 'delayMs' (from the start of the group) - returns its index
+	size_t add( T* target, const T& from, const T& to, double delayMs = 0. )
+	{
+		m_targets.push_back( target );
+		m_from.push_back( from );
+		m_to.push_back( to );
+		m_values.push_back( from );
+		m_delays.push_back( float( std::max( delayMs, 0. ) * .001 ) );
+		m_maxDelay = std::max( m_maxDelay, m_delays.back() );
+		return m_targets.size() - 1;
+	}
+
+	// add a property target (i.e. node->getTranslationProperty()) - skipped once its owner is destroyed
+	size_t add( Property<T> property, const T& from, const T& to, double delayMs = 0. )
+	{
+		auto index = add( nullptr, from, to, delayMs );
+		if ( m_properties.size() < index )
+			m_properties.resize( index );
+		m_properties.push_back( property );
+		return index;
+	}
+
+	// node channels, i.e. addStaggered( nodes, &Node::getScaleProperty, vec3( 0 ), vec3( 1 ), 20. )
+	template <typename NodeT>
+	void addStaggered( const std::vector<std::shared_ptr<NodeT>>& nodes, Property<T> ( NodeT::*channel )(), const T& from, const T& to, double strideMs,
+	                   double firstDelayMs = 0. )
+	{
+		reserve( size() + nodes.size() );
+		for ( size_t i = 0; i < nodes.size(); ++i ) {
+			if ( nodes[i] )
+				add( ( nodes[i].get()->*channel )(), from, to, firstDelayMs + i * strideMs );
+		}
+	}
+
+	// add targets with the same values, each 'strideMs' after the previous one
+	void addStaggered( const std::vector<T*>& targets, const T& from, const T& to, double strideMs, double firstDelayMs = 0. )
+	{
+		reserve( size() + targets.size() );
+		for ( size_t i = 0; i < targets.size(); ++i ) {
+			add( targets[i], from, to, firstDelayMs + i * strideMs );
+		}
+	}
+
+	void reserve( size_t n )
+	{
+		m_targets.reserve( n );
+		m_from.reserve( n );
+		m_to.reserve( n );
+		m_values.reserve( n );
+		m_delays.reserve( n );
+		if ( !m_properties.empty() )
+			m_properties.reserve( n );
+	}
+
+	void clearTargets()
+	{
+		m_targets.clear();
+		m_from.clear();
+		m_to.clear();
+		m_values.clear();
+		m_delays.clear();
+		m_properties.clear();
+		m_maxDelay = 0.f;
+	}
+
+	size_t size() const { return m_targets.size(); }
+
+	// per target duration
+	TweenGroup& setDuration( double durationMs )
+	{
+		m_duration = float( std::max( durationMs, 0. ) * .001 );
+		return *this;
+	}
+	double getDuration() const { return m_duration * 1000.; }
+
+	// from the first target starting to the last one ending
+	double getTotalDuration() const { return ( m_maxDelay + m_duration ) * 1000.; }
+
+	// by type - needs the default, std::function Ease
+	template <typename E = Ease, typename = std::enable_if_t<std::is_same<E, EasingFn>::value>>
+	TweenGroup& setEaseFn( ga::EaseType easeFnType )
+	{
+		m_easeFn = ga::easeFn( easeFnType );
+		return *this;
+	}
+	TweenGroup& setEaseFn( Ease easeFn )
+	{
+		m_easeFn = easeFn;
+		return *this;
+	}
+
+	// assign callback, fired once when every target is done
+	TweenGroup& setOnDone( Callback onDone )
+	{
+		m_onDone = std::move( onDone );
+		return *this;
+	}
+
+	const T& getValue( size_t index ) const { return m_values[index]; }
+	const std::vector<T>& getValues() const { return m_values; }
+
+	virtual void startNow() override
+	{
+		auto now = Timer::now();
+		Timer::set( now, now + std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( m_maxDelay + m_duration ) ) );
+	}
+
+	// recalculates the per target duration, keeping the delays
+	virtual void startNow( long durationMillis ) override
+	{
+		setDuration( durationMillis );
+		startNow();
+	}
+
+	void startAfterDelay( long delayMs )
+	{
+		startNow();
+		auto offset = ga::Millis( delayMs );
+		Timer::set( mBegin_t + offset, mEnd_t + offset );
+	}
+
+	// update every target (call at frame rate, or add to a Timeline)
+	void update()
+	{
+		update_();
+		if ( Timer::isDone() ) {
+			end();
+		}
+	}
+
+	// end animation now (optionally firing callback)
+	void endNow( bool fireCallback = true )
+	{
+		end( fireCallback );
+	}
+
+	// jump to 'pct' (0-1) of the whole group, regardless of the timer and without callbacks (i.e. for scrubbing)
+	void seek( float pct )
+	{
+		evaluate( ga::clamp( pct, 0.f, 1.f ) * ( m_maxDelay + m_duration ) );
+	}
+
+protected:
+	// one pass over every target
+	void evaluate( float seconds )
+	{
+		float invDuration = m_duration > 0.f ? 1.f / m_duration : 0.f;
+		size_t n          = m_targets.size();
+		for ( size_t i = 0; i < n; ++i ) {
+			float t = seconds - m_delays[i];
+			float p = invDuration > 0.f ? ga::clamp( t * invDuration, 0.f, 1.f ) : ( t >= 0.f ? 1.f : 0.f );
+			if ( p > 0.f && p < 1.f )
+				p = ga::clamp( applyEaseFn( m_easeFn, p ), 0.f, 1.f );
+			m_values[i] = p >= 1.f ? m_to[i] : ga::lerp( m_from[i], m_to[i], p );
+			if ( m_targets[i] )
+				*m_targets[i] = m_values[i];
+		}
+		for ( size_t i = 0; i < m_properties.size(); ++i ) {
+			m_properties[i].set( m_values[i] );
+		}
+	}
+
+	void end( bool fireCallback = true ) override
+	{
+		evaluate( m_maxDelay + m_duration );
+		Timer::clear();
+		if ( fireCallback && m_onDone ) {
+			try {
+				m_onDone();
+			} catch ( std::exception& e ) {
+				// todo: log exception
+				m_onDone = nullptr;  // clear callback since it's broken
+			}
+		}
+	}
+
+	bool update_() override
+	{
+		if ( !Timer::isSet() )
+			return false;
+		if ( Timer::isStarted() )
+			evaluate( float( Timer::elapsedSeconds() ) );
+		return !Timer::isDone();
+	}
+
+	bool isDone_() override { return Timer::isDone(); }
+	bool isStarted_() override { return Timer::isStarted(); }
+	void seek_( float pct ) override { seek( pct ); }
+
+	// per target, as arrays
+	std::vector<T*> m_targets;
+	std::vector<T> m_from, m_to, m_values;
+	std::vector<float> m_delays;            // seconds
+	std::vector<Property<T>> m_properties;  // only as long as the last property target
+
+	float m_duration = 0.f;  // seconds, per target
+	float m_maxDelay = 0.f;
+	Ease m_easeFn;
+	Callback m_onDone;
+};
+
+}  // namespace ga